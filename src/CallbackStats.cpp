@@ -0,0 +1,120 @@
+#include <cstring>
+
+#include <Windows.h>
+
+#include "REFramework.hpp"
+#include "CallbackStats.hpp"
+
+using namespace utility::instrumentation;
+
+// module.dll+offset, or just the address if it isn't in a module.
+static utility::FrameString describe_address(void* address) {
+    auto& arena = g_framework->get_frame_arena();
+    HMODULE module{ nullptr };
+
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)address, &module)) {
+        return arena.format("{:x}", (uintptr_t)address);
+    }
+
+    char path[MAX_PATH]{};
+    GetModuleFileNameA(module, path, MAX_PATH);
+
+    auto name = strrchr(path, '\\');
+
+    return arena.format("{}+{:x}", name != nullptr ? name + 1 : path, (uintptr_t)address - (uintptr_t)module);
+}
+
+void CallbackStats::on_frame() {
+    set_hitch_threshold(std::chrono::microseconds{ (int64_t)(m_hitch_threshold_ms->value() * 1000.0f) });
+}
+
+void CallbackStats::on_draw_ui() {
+    ImGui::SetNextTreeNodeOpen(false, ImGuiCond_::ImGuiCond_FirstUseEver);
+
+    if (!ImGui::CollapsingHeader(get_name().data())) {
+        return;
+    }
+
+    auto heap = get_heap_totals();
+
+    ImGui::Text("Frame: %llu", get_frame());
+    ImGui::Text("Heap: %llu allocations, %llu bytes", heap.allocations, heap.bytes);
+
+    m_hitch_threshold_ms->draw("Hitch Threshold (ms)");
+    m_show_idle->draw("Show Idle Callbacks");
+
+    for (auto& stats : get_stats()) {
+        draw_mod(stats);
+    }
+
+    draw_hitches();
+}
+
+void CallbackStats::draw_mod(const Stats& stats) {
+    if (!ImGui::TreeNode(&stats, "%s", stats.get_name().c_str())) {
+        return;
+    }
+
+    ImGui::Columns(6, nullptr, false);
+    ImGui::Text("Callback"); ImGui::NextColumn();
+    ImGui::Text("Calls"); ImGui::NextColumn();
+    ImGui::Text("ms"); ImGui::NextColumn();
+    ImGui::Text("Peak ms"); ImGui::NextColumn();
+    ImGui::Text("Allocs"); ImGui::NextColumn();
+    ImGui::Text("Bytes"); ImGui::NextColumn();
+
+    for (size_t i = 0; i < (size_t)Callback::COUNT; ++i) {
+        auto callback = (Callback)i;
+        auto& last_frame = stats.get_last_frame(callback);
+        auto peak_ns = stats.get_peak_ns(callback);
+
+        if (peak_ns == 0 && !m_show_idle->value()) {
+            continue;
+        }
+
+        ImGui::Text("%s", get_callback_name(callback)); ImGui::NextColumn();
+        ImGui::Text("%llu", last_frame.calls); ImGui::NextColumn();
+        ImGui::Text("%.3f", (double)last_frame.ns / 1'000'000.0); ImGui::NextColumn();
+        ImGui::Text("%.3f", (double)peak_ns / 1'000'000.0); ImGui::NextColumn();
+        ImGui::Text("%llu", last_frame.allocations); ImGui::NextColumn();
+        ImGui::Text("%llu", last_frame.bytes); ImGui::NextColumn();
+    }
+
+    ImGui::Columns(1);
+    ImGui::TreePop();
+}
+
+void CallbackStats::draw_hitches() {
+    auto& hitches = get_hitches();
+
+    if (!ImGui::TreeNode(&hitches, "Hitches (%zu)", hitches.size())) {
+        return;
+    }
+
+    if (ImGui::Button("Clear")) {
+        clear_hitches();
+    }
+
+    // Newest first.
+    for (auto it = hitches.rbegin(); it != hitches.rend(); ++it) {
+        auto& hitch = *it;
+
+        if (!ImGui::TreeNode(&hitch, "Frame %llu: %.3f ms, slowest %s %s %.3f ms", hitch.frame, (double)hitch.total_ns / 1'000'000.0,
+            hitch.mod.c_str(), get_callback_name(hitch.callback), (double)hitch.ns / 1'000'000.0))
+        {
+            continue;
+        }
+
+        if (hitch.stack.empty()) {
+            ImGui::TextWrapped("No stack, the callback finished before the watchdog looked at it.");
+        }
+
+        for (auto address : hitch.stack) {
+            ImGui::Text("%s", describe_address(address).c_str());
+        }
+
+        ImGui::TreePop();
+    }
+
+    ImGui::TreePop();
+}
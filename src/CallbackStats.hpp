@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Mod.hpp"
+
+// Shows what utility::instrumentation measured for each mod in the last frame, and the recent hitches.
+// Only built into INSTRUMENTED builds.
+class CallbackStats : public Mod {
+public:
+    std::string_view get_name() const override { return "CallbackStats"; };
+
+    void on_frame() override;
+    void on_draw_ui() override;
+
+private:
+    void draw_mod(const utility::instrumentation::Stats& stats);
+    void draw_hitches();
+
+    const ModSlider::Ptr m_hitch_threshold_ms{ ModSlider::create(generate_name("HitchThresholdMs"), 0.1f, 33.0f, 4.0f) };
+    const ModToggle::Ptr m_show_idle{ ModToggle::create(generate_name("ShowIdle"), false) };
+};
@@ -41,16 +41,18 @@ bool D3D11Hook::hook() {
         return false;
     }
 
+    // Present is hooked inline, the dummy swap chain isn't guaranteed to share a vtable with the game's.
     auto present_fn = (*(uintptr_t**)swap_chain)[8];
-    auto resize_buffers_fn = (*(uintptr_t**)swap_chain)[13];
     m_present_hook = std::make_unique<FunctionHook>(present_fn, (uintptr_t)&D3D11Hook::present);
-    m_resize_buffers_hook = std::make_unique<FunctionHook>(resize_buffers_fn, (uintptr_t)&D3D11Hook::resize_buffers);
 
     device->Release();
     context->Release();
     swap_chain->Release();
 
-    m_hooked = m_present_hook->create() && m_resize_buffers_hook->create();
+    FunctionHookTransaction transaction{};
+    transaction.add(*m_present_hook, "Present");
+
+    m_hooked = transaction.commit();
 
     return m_hooked;
 }
@@ -65,6 +67,18 @@ HRESULT WINAPI D3D11Hook::present(IDXGISwapChain* swap_chain, UINT sync_interval
     d3d11->m_swap_chain = swap_chain;
     swap_chain->GetDevice(__uuidof(d3d11->m_device), (void**)&d3d11->m_device);
 
+    if (d3d11->m_resize_buffers_hook == nullptr && !d3d11->m_resize_buffers_hook_failed) {
+        d3d11->m_resize_buffers_hook = std::make_unique<VtableHook>(swap_chain, 13, (uintptr_t)&D3D11Hook::resize_buffers);
+
+        // Not retried, whatever stopped it would stop it every frame.
+        if (!d3d11->m_resize_buffers_hook->create()) {
+            spdlog::error("Failed to hook ResizeBuffers, resizing the game won't be handled");
+
+            d3d11->m_resize_buffers_hook.reset();
+            d3d11->m_resize_buffers_hook_failed = true;
+        }
+    }
+
     if (d3d11->m_on_present) {
         d3d11->m_on_present(*d3d11);
     }
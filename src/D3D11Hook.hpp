@@ -6,6 +6,7 @@
 #include <dxgi.h>
 
 #include "utility/FunctionHook.hpp"
+#include "utility/SlotHook.hpp"
 
 class D3D11Hook {
 public:
@@ -30,7 +31,9 @@ protected:
     bool m_hooked{ false };
 
     std::unique_ptr<FunctionHook> m_present_hook{};
-    std::unique_ptr<FunctionHook> m_resize_buffers_hook{};
+    // Hooked in the vtable of the game's swap chain once the first Present shows us it.
+    std::unique_ptr<VtableHook> m_resize_buffers_hook{};
+    bool m_resize_buffers_hook_failed{ false };
     OnPresentFn m_on_present{ nullptr };
     OnResizeBuffersFn m_on_resize_buffers{ nullptr };
 
@@ -1,9 +1,11 @@
 #include "ObjectExplorer.hpp"
+#include "SignatureTool.hpp"
 
 #include "DeveloperTools.hpp"
 
 DeveloperTools::DeveloperTools() {
     m_tools.push_back(std::make_shared<ObjectExplorer>());
+    m_tools.push_back(std::make_shared<SignatureTool>());
 }
 
 void DeveloperTools::on_draw_ui() {
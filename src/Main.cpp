@@ -37,6 +37,7 @@ void startup_thread() {
         }
 
         g_framework = std::make_unique<REFramework>();
+        g_framework->prewarm();
     }
     else {
         failed();
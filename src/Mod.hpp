@@ -5,6 +5,7 @@
 
 #include <dinput.h>
 
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -13,6 +14,8 @@
 
 #include "sdk/ReClass.hpp"
 #include "utility/Config.hpp"
+#include "utility/Instrumentation.hpp"
+#include "utility/Sampler.hpp"
 
 #include "REFramework.hpp"
 
@@ -20,15 +23,39 @@ class IModValue {
 public:
     using Ptr = std::unique_ptr<IModValue>;
 
-    virtual ~IModValue() = default;
+    // Every value that exists, so the config can be loaded and saved without each mod listing its values.
+    // Values are created along with their mods before any frame uses them, the list isn't locked.
+    // Leaked on purpose: values are destroyed with g_framework at exit, which can be after a static list would be gone.
+    static std::vector<IModValue*>& get_registry() {
+        static auto registry = new std::vector<IModValue*>{};
+        return *registry;
+    }
+
+    IModValue() {
+        get_registry().push_back(this);
+    }
+
+    IModValue(const IModValue& other) = delete;
+    IModValue& operator=(const IModValue& other) = delete;
+
+    virtual ~IModValue() {
+        auto& registry = get_registry();
+        registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+    }
 
     virtual bool draw(std::string_view name) = 0;
 
     virtual void draw_value(std::string_view name) = 0;
 
-    virtual void config_load(const utility::Config &cfg) = 0;
+    // Either the mapped binary config at startup, or the keys that changed in the text config.
+    virtual void config_load(const utility::ConfigReader &cfg) = 0;
 
     virtual void config_save(utility::Config &cfg) = 0;
+
+    // Whether the value changed since it was last loaded or saved.
+    virtual bool is_dirty() const = 0;
+
+    virtual void mark_clean() = 0;
 };
 
 // Convenience classes for imgui
@@ -43,23 +70,35 @@ public:
 
     ModValue(std::string_view config_name, T default_value)
             : m_config_name{config_name},
-              m_value{default_value} {
+              m_value{default_value},
+              m_saved_value{default_value} {
     }
 
     ~ModValue() override = default;;
 
-    void config_load(const utility::Config &cfg) override {
+    void config_load(const utility::ConfigReader &cfg) override {
         auto v = cfg.get<T>(m_config_name);
 
         if (v) {
             m_value = *v;
         }
+
+        m_saved_value = m_value;
     };
 
     void config_save(utility::Config &cfg) override {
         cfg.set<T>(m_config_name, m_value);
     };
 
+    // Compared rather than flagged on write, value() hands out a mutable reference.
+    [[nodiscard]] bool is_dirty() const override {
+        return m_value != m_saved_value;
+    }
+
+    void mark_clean() override {
+        m_saved_value = m_value;
+    }
+
     explicit operator T &() {
         return m_value;
     }
@@ -74,6 +113,7 @@ public:
 
 protected:
     T m_value{};
+    T m_saved_value{};
     std::string m_config_name{"Default_ModValue"};
 };
 
@@ -247,19 +287,28 @@ public:
         return g_framework->get_keyboard_state()[(uint8_t) m_value] != 0;
     }
 
+    // Uses the press count from the input thread rather than comparing against the last frame,
+    // so presses shorter than a frame still register.
     bool is_key_down_once() {
-        auto down = is_key_down();
+        if (m_value < 0 || m_value > 255) {
+            return false;
+        }
+
+        auto presses = g_framework->get_keyboard().presses[(uint8_t) m_value];
 
-        if (!m_was_key_down && down) {
-            m_was_key_down = true;
-            return true;
+        // Presses from before the first poll, or of the key this was bound to before, don't count.
+        if (m_value != m_polled_key) {
+            m_polled_key = m_value;
+            m_last_presses = presses;
+            return false;
         }
 
-        if (!down) {
-            m_was_key_down = false;
+        if (presses == m_last_presses) {
+            return false;
         }
 
-        return false;
+        m_last_presses = presses;
+        return true;
     }
 
     [[nodiscard]] bool is_erase_key(int k) const {
@@ -276,7 +325,9 @@ public:
     static constexpr int32_t UNBOUND_KEY = -1;
 
 protected:
-    bool m_was_key_down{false};
+    // The key m_last_presses was counted for.
+    int32_t m_polled_key{UNBOUND_KEY};
+    uint32_t m_last_presses{0};
 };
 
 class Mod {
@@ -300,11 +351,21 @@ public:
 
     virtual void on_draw_ui() {};
 
-    virtual void on_config_load(const utility::Config &cfg) {};
+    // ModValues are loaded and saved on their own, these are only needed for anything else a mod keeps in the config.
+    // on_config_save only runs when some ModValue changed.
+    virtual void on_config_load(const utility::ConfigReader &cfg) {};
 
     virtual void on_config_save(utility::Config &cfg) {};
 
     // Game-specific callbacks
+    // The engine calls these constantly. A mod that only needs some of the calls can say so here,
+    // the policy is read once when the hooks start dispatching and applies to the pre and post callback alike.
+    virtual utility::SamplingPolicy get_update_transform_sampling() const { return {}; }
+
+    virtual utility::SamplingPolicy get_update_camera_controller_sampling() const { return {}; }
+
+    virtual utility::SamplingPolicy get_update_camera_controller2_sampling() const { return {}; }
+
     virtual void on_pre_update_transform(RETransform *transform) {};
 
     virtual void on_update_transform(RETransform *transform) {};
@@ -316,5 +377,15 @@ public:
     virtual void on_pre_update_camera_controller2(RopewayPlayerCameraController *controller) {};
 
     virtual void on_update_camera_controller2(RopewayPlayerCameraController *controller) {};
+
+#ifdef INSTRUMENTED
+    // Set up by Mods when the mod is added, null for mods created anywhere else.
+    utility::instrumentation::Stats* get_stats() const { return m_stats; }
+
+private:
+    friend class Mods;
+
+    utility::instrumentation::Stats* m_stats{ nullptr };
+#endif
 };
 
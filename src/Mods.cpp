@@ -1,9 +1,16 @@
 #include <spdlog/spdlog.h>
 
+#include "utility/BinaryConfig.hpp"
+
 #include "IntegrityCheckBypass.hpp"
 #include "PositionHooks.hpp"
 #include "DeveloperTools.hpp"
 #include "Speedrun.h"
+#include "TransformRecorder.hpp"
+
+#ifdef INSTRUMENTED
+#include "CallbackStats.hpp"
+#endif
 
 #include "Mods.hpp"
 #include "ObjectExplorer.hpp"
@@ -16,10 +23,19 @@ Mods::Mods()
 
     m_mods.emplace_back(std::make_unique<PositionHooks>());
     m_mods.emplace_back(std::make_unique<Speedrun>());
+    m_mods.emplace_back(std::make_unique<TransformRecorder>());
 
 #ifdef DEVELOPER
     m_mods.emplace_back(std::make_unique<DeveloperTools>());
 #endif
+
+#ifdef INSTRUMENTED
+    m_mods.emplace_back(std::make_unique<CallbackStats>());
+
+    for (auto& mod : m_mods) {
+        mod->m_stats = &utility::instrumentation::add_stats(mod->get_name());
+    }
+#endif
 }
 
 std::optional<std::string> Mods::on_initialize() const {
@@ -29,10 +45,16 @@ std::optional<std::string> Mods::on_initialize() const {
             return e;
         }
     }
-    utility::Config cfg{"re2_fw_config.txt"};
+    // Values are read straight out of the mapped file, nothing is parsed or copied up front.
+    auto cfg = utility::BinaryConfig::load(REFramework::CONFIG_PATH, REFramework::CONFIG_TEXT_PATH);
+
+    for (auto value : IModValue::get_registry()) {
+        value->config_load(*cfg);
+    }
 
     for (auto &mod : m_mods) {
-        mod->on_config_load(cfg);
+        INSTRUMENT_CALLBACK(*mod, ON_CONFIG_LOAD);
+        mod->on_config_load(*cfg);
     }
 
     return std::nullopt;
@@ -40,12 +62,14 @@ std::optional<std::string> Mods::on_initialize() const {
 
 void Mods::on_frame() const {
     for (auto &mod : m_mods) {
+        INSTRUMENT_CALLBACK(*mod, ON_FRAME);
         mod->on_frame();
     }
 }
 
 void Mods::on_draw_ui() const {
     for (auto &mod : m_mods) {
+        INSTRUMENT_CALLBACK(*mod, ON_DRAW_UI);
         mod->on_draw_ui();
     }
 }
@@ -5,7 +5,6 @@
 #include <windows.h>
 
 #include "utility/String.hpp"
-#include "utility/Scan.hpp"
 
 #include "REFramework.hpp"
 #include "ObjectExplorer.hpp"
@@ -24,6 +23,7 @@ void ObjectExplorer::on_draw_ui() {
     }
 
     if (m_do_init) {
+        subscribe_globals();
         populate_classes();
         populate_enums();
     }
@@ -37,27 +37,12 @@ void ObjectExplorer::on_draw_ui() {
             m_next_refresh = curtime + std::chrono::seconds(1);
         }
 
-        // make a copy, we want to sort by name
-        auto singletons = g_framework->get_globals()->get_objects();
-
-        // first loop, sort
-        std::sort(singletons.begin(), singletons.end(), [](REManagedObject** a, REManagedObject** b) {
-            auto a_type = utility::re_managed_object::safe_get_type(*a);
-            auto b_type = utility::re_managed_object::safe_get_type(*b);
-
-            if (a_type == nullptr || a_type->name == nullptr) {
-                return true;
-            }
-
-            if (b_type == nullptr || b_type->name == nullptr) {
-                return false;
-            }
-
-            return std::string_view{ a_type->name } < std::string_view{ b_type->name };
-        });
+        if (m_singletons_dirty.exchange(false)) {
+            sort_singletons();
+        }
 
         // Display the nodes
-        for (auto obj : singletons) {
+        for (auto obj : m_singletons) {
             auto t = utility::re_managed_object::safe_get_type(*obj);
 
             if (t == nullptr || t->name == nullptr) {
@@ -77,7 +62,7 @@ void ObjectExplorer::on_draw_ui() {
     }
 
     if (ImGui::CollapsingHeader("Types")) {
-        std::vector<uint8_t> fake_type{ 0 };
+        utility::FrameVector<uint8_t> fake_type(1, 0, &g_framework->get_frame_arena());
 
         for (const auto& name : m_sorted_types) {
             fake_type.clear();
@@ -121,7 +106,7 @@ void ObjectExplorer::on_draw_ui() {
         handle_address(std::stoull(m_object_address, nullptr, 16));
     }
 
-    std::vector<uint8_t> fake_type{ 0 };
+    utility::FrameVector<uint8_t> fake_type(1, 0, &g_framework->get_frame_arena());
 
     for (auto t : m_displayed_types) {
         fake_type.clear();
@@ -133,6 +118,39 @@ void ObjectExplorer::on_draw_ui() {
     m_do_init = false;
 }
 
+void ObjectExplorer::subscribe_globals() {
+    auto& globals = g_framework->get_globals();
+
+    if (globals == nullptr) {
+        return;
+    }
+
+    // Can be called from whichever thread refreshed, the list is sorted on the next draw.
+    globals->on_change([this](REManagedObject**, REManagedObject*, REManagedObject*) {
+        m_singletons_dirty = true;
+    });
+}
+
+void ObjectExplorer::sort_singletons() {
+    auto& objects = g_framework->get_globals()->get_objects();
+    m_singletons.assign(objects.begin(), objects.end());
+
+    std::sort(m_singletons.begin(), m_singletons.end(), [](REManagedObject** a, REManagedObject** b) {
+        auto a_type = utility::re_managed_object::safe_get_type(*a);
+        auto b_type = utility::re_managed_object::safe_get_type(*b);
+
+        if (a_type == nullptr || a_type->name == nullptr) {
+            return b_type != nullptr && b_type->name != nullptr;
+        }
+
+        if (b_type == nullptr || b_type->name == nullptr) {
+            return false;
+        }
+
+        return std::string_view{ a_type->name } < std::string_view{ b_type->name };
+    });
+}
+
 void ObjectExplorer::handle_address(Address address, int32_t offset, Address parent) {
     if (!is_managed_object(address)) {
         return;
@@ -152,12 +170,12 @@ void ObjectExplorer::handle_address(Address address, int32_t offset, Address par
 
         made_node = stretched_tree_node(parent.get(offset), "0x%X:", offset);
         auto is_hovered = ImGui::IsItemHovered();
-        auto additional_text = std::string{};
+        auto additional_text = g_framework->get_frame_arena().make_string();
 
         context_menu(object);
 
         if (is_game_object) {
-            additional_text = utility::re_string::get_string(address.as<REGameObject*>()->name);
+            additional_text = utility::re_string::get_string(address.as<REGameObject*>()->name).c_str();
         }
         else {
             // Change name based on VMType
@@ -165,12 +183,10 @@ void ObjectExplorer::handle_address(Address address, int32_t offset, Address par
             case via::clr::VMObjType::Array:
             {
                 auto arr = (REArrayBase*)object;
-                std::string name{};
-                name += "Array<";
-                name += arr->containedType != nullptr ? arr->containedType->type->name : "";
-                name += ">";
 
-                additional_text = name;
+                additional_text += "Array<";
+                additional_text += arr->containedType != nullptr ? arr->containedType->type->name : "";
+                additional_text += ">";
                 break;
             }
 
@@ -764,20 +780,19 @@ int32_t ObjectExplorer::get_field_offset(REManagedObject* obj, VariableDescripto
                     if (func1 == nullptr) {
                         spdlog::info("Locating funcs");
                         
-                        // Version 1
-                        //auto ref = utility::scan(g_framework->getModule().as<HMODULE>(), "48 83 78 18 00 74 ? 48 89 D9 E8 ? ? ? ? 48 89 D9 E8 ? ? ? ?");
+                        auto& signatures = g_framework->get_signatures();
+                        auto cleanup1 = signatures.get("ThreadContextCleanup1");
+                        auto cleanup2 = signatures.get("ThreadContextCleanup2");
+                        auto cleanup3 = signatures.get("ThreadContextCleanup3");
 
-                        // Version 2 Dec 17th, 2019 game.exe+0x20437C (works on old version too)
-                        auto ref = utility::scan(g_framework->get_module().as<HMODULE>(), "48 83 78 18 00 74 ? 48 ? ? E8 ? ? ? ? 48 ? ? E8 ? ? ? ?");
-
-                        if (!ref) {
+                        if (!cleanup1 || !cleanup2 || !cleanup3) {
                             spdlog::error("We're going to crash");
                             break;
                         }
 
-                        func1 = Address{ utility::calculate_absolute(*ref + 11) }.as<decltype(func1)>();
-                        func2 = Address{ utility::calculate_absolute(*ref + 19) }.as<decltype(func2)>();
-                        func3 = Address{ utility::calculate_absolute(*ref + 27) }.as<decltype(func3)>();
+                        func1 = Address{ *cleanup1 }.as<decltype(func1)>();
+                        func2 = Address{ *cleanup2 }.as<decltype(func2)>();
+                        func3 = Address{ *cleanup3 }.as<decltype(func3)>();
 
                         spdlog::info("F1 {:x}", (uintptr_t)func1);
                         spdlog::info("F2 {:x}", (uintptr_t)func2);
@@ -984,8 +999,14 @@ void ObjectExplorer::populate_enums() {
     std::ofstream out_file("Enums_Internal.hpp");
 
 
-    auto ref = utility::scan(g_framework->get_module().as<HMODULE>(), "66 C7 40 18 01 01 48 89 05 ? ? ? ?");
-    auto& l = *(std::map<uint64_t, REEnumData>*)(utility::calculate_absolute(*ref + 9));
+    auto enum_list = g_framework->get_signatures().get("EnumList");
+
+    if (!enum_list) {
+        spdlog::error("Unable to find EnumList");
+        return;
+    }
+
+    auto& l = *(std::map<uint64_t, REEnumData>*)*enum_list;
     spdlog::info("EnumList: {:x}", (uintptr_t)&l);
 
     spdlog::info("Size: {}", l.size());
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <unordered_set>
 
 #include <imgui/imgui.h>
@@ -35,6 +36,8 @@ private:
     void make_tree_offset(REManagedObject* object, uint32_t offset, std::string_view name);
     bool is_managed_object(Address address) const;
 
+    void subscribe_globals();
+    void sort_singletons();
     void populate_classes();
     void populate_enums();
 
@@ -60,6 +63,10 @@ private:
     std::string m_object_address{ "0" };
     std::chrono::system_clock::time_point m_next_refresh;
 
+    // Sorted by type name, only re-sorted when REGlobals reports a slot changed.
+    std::vector<REManagedObject**> m_singletons;
+    std::atomic<bool> m_singletons_dirty{ true };
+
     std::unordered_map<VariableDescriptor*, int32_t> m_offset_map;
 
     struct EnumDescriptor {
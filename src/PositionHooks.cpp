@@ -1,72 +1,157 @@
+#include <atomic>
+#include <chrono>
+
 #include "Mods.hpp"
 #include "REFramework.hpp"
 #include "utility/Scan.hpp"
 #include "utility/Module.hpp"
+#include "utility/StaticHook.hpp"
 
 #include "PositionHooks.hpp"
 
-PositionHooks* g_hook = nullptr;
+namespace {
+    struct Subscriber {
+        Mod* mod;
+        utility::Sampler sampler;
+    };
 
-PositionHooks::PositionHooks() {
-    g_hook = this;
-}
+    // Which calls were sampled for which subscribers is kept in a 64 bit mask.
+    constexpr size_t MAX_SUBSCRIBERS{ 64 };
 
-std::optional<std::string> PositionHooks::on_initialize() {
-    auto game = g_framework->get_module().as<HMODULE>();
+    // Built before dispatching is enabled.
+    std::vector<Subscriber> g_update_transform_subscribers{};
+    std::vector<Subscriber> g_update_camera_controller_subscribers{};
+    std::vector<Subscriber> g_update_camera_controller2_subscribers{};
 
-    // The 48 8B 4D 40 bit might change.
-    // Version 1.0 jmp stub: game+0x1dc7de0
-    // Version 1
-    //auto updateTransformCall = utility::scan(game, "E8 ? ? ? ? 48 8B 5B ? 48 85 DB 75 ? 48 8B 4D 40 48 31 E1");
+    // Advanced by on_frame, for the frame budget policy.
+    std::atomic<uint64_t> g_frame{ 0 };
 
-    // Version 2 Dec 17th, 2019 (works on old version too) game.exe+0x1DD3FF0
-    auto update_transform_call = utility::scan(game, "E8 ? ? ? ? 48 8B 5B ? 48 85 DB 75 ? 48 8B 4D 40 48 ? ?");
+    template <typename Callback>
+    void call(Subscriber& subscriber, utility::instrumentation::Callback kind, const Callback& callback) {
+#ifdef INSTRUMENTED
+        utility::instrumentation::Scope scope{ subscriber.mod->get_stats(), kind };
+#endif
 
-    if (!update_transform_call) {
-        return "Unable to find UpdateTransform pattern.";
+        if (!subscriber.sampler.is_timed()) {
+            callback(subscriber.mod);
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        callback(subscriber.mod);
+        subscriber.sampler.spend(std::chrono::steady_clock::now() - start);
     }
 
-    auto update_transform = utility::calculate_absolute(*update_transform_call + 1);
-    spdlog::info("UpdateTransform: {:x}", update_transform);
+    template <typename Pre, typename Original, typename Post>
+    void* dispatch_sampled(std::vector<Subscriber>& subscribers, utility::instrumentation::Callback kind, const Pre& pre, const Original& original, const Post& post) {
+        auto frame = g_frame.load(std::memory_order_relaxed);
+        // The subscribers that get this call, the post callback goes to the same ones as the pre callback.
+        uint64_t sampled{ 0 };
 
-    // Can be found by breakpointing RETransform's worldTransform
-    m_update_transform_hook = std::make_unique<FunctionHook>(update_transform, &update_transform_hook);
+        for (size_t i = 0; i < subscribers.size(); ++i) {
+            if (subscribers[i].sampler.sample(frame)) {
+                sampled |= 1ull << i;
+                call(subscribers[i], kind, pre);
+            }
+        }
 
-    if (!m_update_transform_hook->create()) {
-        return "Failed to hook UpdateTransform";
+        auto ret = original();
+
+        for (size_t i = 0; i < subscribers.size(); ++i) {
+            if ((sampled & (1ull << i)) != 0) {
+                call(subscribers[i], kind, post);
+            }
+        }
+
+        return ret;
     }
 
-    // Version 1.0 jmp stub: game+0xB4685A0
-    // Version 1
-    /*auto updatecamera_controllerCall = utility::scan(game, "75 ? 48 89 FA 48 89 D9 E8 ? ? ? ? 48 8B 43 50 48 83 78 18 00 75 ? 45 89");
+    template <typename GetPolicy>
+    std::vector<Subscriber> subscribe(const std::vector<std::shared_ptr<Mod>>& mods, const GetPolicy& get_policy) {
+        std::vector<Subscriber> subscribers{};
+
+        for (auto& mod : mods) {
+            auto policy = get_policy(*mod);
+
+            if (policy.kind == utility::SamplingPolicy::Kind::NEVER) {
+                continue;
+            }
+
+            if (subscribers.size() == MAX_SUBSCRIBERS) {
+                spdlog::error("[PositionHooks] Too many subscribers, {} won't be called", mod->get_name().data());
+                continue;
+            }
+
+            subscribers.push_back({ mod.get(), utility::Sampler{ policy } });
+        }
 
-    if (!updatecamera_controllerCall) {
-        return "Unable to find Updatecamera_controller pattern.";
+        return subscribers;
     }
 
-    auto updatecamera_controller = utility::calculate_absolute(*updatecamera_controllerCall + 9);*/
+    struct UpdateTransform {
+        static void* dispatch(void* (*original)(RETransform*, uint8_t, uint32_t), RETransform* t, uint8_t a2, uint32_t a3) {
+            return dispatch_sampled(g_update_transform_subscribers, utility::instrumentation::Callback::UPDATE_TRANSFORM,
+                [&](Mod* mod) { mod->on_pre_update_transform(t); },
+                [&] { return original(t, a2, a3); },
+                [&](Mod* mod) { mod->on_update_transform(t); });
+        }
+    };
+
+    struct UpdateCameraController {
+        static void* dispatch(void* (*original)(void*, RopewayPlayerCameraController*), void* a1, RopewayPlayerCameraController* camera_controller) {
+            return dispatch_sampled(g_update_camera_controller_subscribers, utility::instrumentation::Callback::UPDATE_CAMERA_CONTROLLER,
+                [&](Mod* mod) { mod->on_pre_update_camera_controller(camera_controller); },
+                [&] { return original(a1, camera_controller); },
+                [&](Mod* mod) { mod->on_update_camera_controller(camera_controller); });
+        }
+    };
+
+    struct UpdateCameraController2 {
+        static void* dispatch(void* (*original)(void*, RopewayPlayerCameraController*), void* a1, RopewayPlayerCameraController* camera_controller) {
+            return dispatch_sampled(g_update_camera_controller2_subscribers, utility::instrumentation::Callback::UPDATE_CAMERA_CONTROLLER2,
+                [&](Mod* mod) { mod->on_pre_update_camera_controller2(camera_controller); },
+                [&] { return original(a1, camera_controller); },
+                [&](Mod* mod) { mod->on_update_camera_controller2(camera_controller); });
+        }
+    };
+
+    using UpdateTransformHook = StaticHook<UpdateTransform, void*(RETransform*, uint8_t, uint32_t)>;
+    using UpdateCameraControllerHook = StaticHook<UpdateCameraController, void*(void*, RopewayPlayerCameraController*)>;
+    using UpdateCameraController2Hook = StaticHook<UpdateCameraController2, void*(void*, RopewayPlayerCameraController*)>;
+}
 
-    // Version 2 Dec 17th, 2019 game.exe+0x7CF690 (works on old version too)
-    auto update_camera_controller = utility::scan(game, "40 55 56 57 48 8D AC 24 ? ? ? ? 48 81 EC ? ? 00 00 48 8B 41 50");
+PositionHooks::~PositionHooks() {
+    UpdateTransformHook::set_dispatching(false);
+    UpdateCameraControllerHook::set_dispatching(false);
+    UpdateCameraController2Hook::set_dispatching(false);
+}
 
-    spdlog::info("UpdateCameraController: {:x}", *update_camera_controller);
+std::optional<std::string> PositionHooks::on_initialize() {
+    auto& signatures = g_framework->get_signatures();
 
-    // Can be found by breakpointing camera controller's worldPosition
-    m_update_camera_controller_hook = std::make_unique<FunctionHook>(*update_camera_controller, &update_camera_controller_hook);
+    // These fall back to the closest match when a game update shifts a byte or two,
+    // the log says which pattern needs updating.
+    auto update_transform = signatures.get_approximate("UpdateTransform");
 
-    if (!m_update_camera_controller_hook->create()) {
-        return "Failed to hook UpdateCameraController";
+    if (!update_transform) {
+        return "Unable to find UpdateTransform pattern.";
+    }
+
+    spdlog::info("UpdateTransform: {:x}", *update_transform);
+
+    auto update_camera_controller = signatures.get_approximate("UpdateCameraController");
+
+    if (!update_camera_controller) {
+        return "Unable to find UpdateCameraController pattern.";
     }
 
-    // Version 1.0 jmp stub: game+0xCF2510
-    // Version 1.0 function: game+0xB436230
-    
-    // Version 1
-    //auto updatecamera_controller2 = utility::scan(game, "40 53 57 48 81 ec ? ? ? ? 48 8b 41 ? 48 89 d7 48 8b 92 ? ? 00 00");
-    // Version 2 Dec 17th, 2019 game.exe+0x6CD9C0 (works on old version too)
-    auto update_camera_controller2 = utility::scan(game, "40 53 57 48 81 EC ? ? ? ? 48 ? ? ? 48 ? ? 48 ? ? ? ? 00 00");
+    spdlog::info("UpdateCameraController: {:x}", *update_camera_controller);
+
+    auto update_camera_controller2 = signatures.get_approximate("UpdateCameraController2");
 
 #ifdef RE3
+    auto game = g_framework->get_module().as<HMODULE>();
+
     while (update_camera_controller2) {
         if (utility::scan(*update_camera_controller2, 0x100, "0F B6 4F 51")) {
             break;
@@ -84,85 +169,39 @@ std::optional<std::string> PositionHooks::on_initialize() {
 
     spdlog::info("Updatecamera_controller2: {:x}", *update_camera_controller2);
 
-    // Can be found by breakpointing camera controller's worldRotation
-    m_update_camera_controller2_hook = std::make_unique<FunctionHook>(*update_camera_controller2, &update_camera_controller2_hook);
-
-    if (!m_update_camera_controller2_hook->create()) {
-        return "Failed to hook Updatecamera_controller2";
-    }
+    m_update_transform_hook = UpdateTransformHook::create(*update_transform);
+    m_update_camera_controller_hook = UpdateCameraControllerHook::create(*update_camera_controller);
+    m_update_camera_controller2_hook = UpdateCameraController2Hook::create(*update_camera_controller2);
 
-    return Mod::on_initialize();
-}
-
-void* PositionHooks::update_transform_hook_internal(RETransform* t, uint8_t a2, uint32_t a3) {
-    if (!g_framework->is_ready()) {
-        return m_update_transform_hook->get_original<decltype(update_transform_hook)>()(t, a2, a3);
-    }
-
-    auto& mods = g_framework->get_mods()->get_mods();
+    // Enable all of them at once so the game's threads only get suspended once.
+    FunctionHookTransaction transaction{};
+    transaction.add(*m_update_transform_hook, "UpdateTransform");
+    transaction.add(*m_update_camera_controller_hook, "UpdateCameraController");
+    transaction.add(*m_update_camera_controller2_hook, "UpdateCameraController2");
 
-    for (auto& mod : mods) {
-        mod->on_pre_update_transform(t);
+    if (!transaction.commit()) {
+        return transaction.get_errors().front();
     }
 
-    auto ret = m_update_transform_hook->get_original<decltype(update_transform_hook)>()(t, a2, a3);
-
-    for (auto& mod : mods) {
-        mod->on_update_transform(t);
-    }
-
-    return ret;
-}
-
-void* PositionHooks::update_transform_hook(RETransform* t, uint8_t a2, uint32_t a3) {
-    return g_hook->update_transform_hook_internal(t, a2, a3);
-}
-
-void* PositionHooks::update_camera_controller_hook_internal(void* a1, RopewayPlayerCameraController* camera_controller) {
-    if (!g_framework->is_ready()) {
-        return m_update_camera_controller_hook->get_original<decltype(update_camera_controller_hook)>()(a1, camera_controller);
-    }
-
-    auto& mods = g_framework->get_mods()->get_mods();
-
-    for (auto& mod : mods) {
-        mod->on_pre_update_camera_controller(camera_controller);
-    }
-
-    auto ret = m_update_camera_controller_hook->get_original<decltype(update_camera_controller_hook)>()(a1, camera_controller);
-
-    for (auto& mod : mods) {
-        mod->on_update_camera_controller(camera_controller);
-    }
-
-    return ret;
+    return Mod::on_initialize();
 }
 
-void* PositionHooks::update_camera_controller_hook(void* a1, RopewayPlayerCameraController* camera_controller) {
-    return g_hook->update_camera_controller_hook_internal(a1, camera_controller);
-}
+void PositionHooks::on_frame() {
+    g_frame.fetch_add(1, std::memory_order_relaxed);
 
-void* PositionHooks::update_camera_controller2_hook_internal(void* a1, RopewayPlayerCameraController* camera_controller) {
-    if (!g_framework->is_ready()) {
-        return m_update_camera_controller2_hook->get_original<decltype(update_camera_controller2_hook)>()(a1, camera_controller);
+    if (m_dispatching) {
+        return;
     }
 
     auto& mods = g_framework->get_mods()->get_mods();
 
-    for (auto& mod : mods) {
-        mod->on_pre_update_camera_controller2(camera_controller);
-    }
-
-    auto ret = m_update_camera_controller2_hook->get_original<decltype(update_camera_controller2_hook)>()(a1, camera_controller);
+    g_update_transform_subscribers = subscribe(mods, [](const Mod& mod) { return mod.get_update_transform_sampling(); });
+    g_update_camera_controller_subscribers = subscribe(mods, [](const Mod& mod) { return mod.get_update_camera_controller_sampling(); });
+    g_update_camera_controller2_subscribers = subscribe(mods, [](const Mod& mod) { return mod.get_update_camera_controller2_sampling(); });
 
-    for (auto& mod : mods) {
-        mod->on_update_camera_controller2(camera_controller);
-    }
-
-    return ret;
-}
+    UpdateTransformHook::set_dispatching(true);
+    UpdateCameraControllerHook::set_dispatching(true);
+    UpdateCameraController2Hook::set_dispatching(true);
 
-void* PositionHooks::update_camera_controller2_hook(void* a1, RopewayPlayerCameraController* camera_controller) {
-    return g_hook->update_camera_controller2_hook_internal(a1, camera_controller);
+    m_dispatching = true;
 }
-
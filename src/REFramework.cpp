@@ -6,6 +6,7 @@
 #include "re2-imgui/imgui_impl_win32.h"
 #include "re2-imgui/imgui_impl_dx11.h"
 
+#include "utility/BinaryConfig.hpp"
 #include "utility/Module.hpp"
 #include "utility/DroidFont.cpp"
 
@@ -13,13 +14,16 @@
 #include "Mods.hpp"
 
 #include "LicenseStrings.hpp"
+#include "Signatures.hpp"
 #include "REFramework.hpp"
 
 std::unique_ptr<REFramework> g_framework{};
 
 REFramework::REFramework() :
         m_game_module{GetModuleHandle(0)},
-        m_logger{spdlog::basic_logger_mt("REFramework", "re2_framework_log.txt", true)} {
+        m_logger{spdlog::basic_logger_mt("REFramework", "re2_framework_log.txt", true)},
+        m_config_writer{std::make_unique<utility::ConfigWriter>(CONFIG_PATH, utility::BinaryConfig::save)},
+        m_config_exporter{std::make_unique<utility::ConfigWriter>(CONFIG_TEXT_PATH)} {
     spdlog::set_default_logger(m_logger);
     spdlog::flush_on(spdlog::level::info);
     spdlog::info("REFramework entry");
@@ -52,6 +56,55 @@ REFramework::REFramework() :
 
 REFramework::~REFramework() = default;
 
+void REFramework::prewarm() {
+    spdlog::info("Pre-warming game data");
+
+    // Anything thrown here has to reach the promise, the game data initialization waits on it.
+    try {
+        m_signatures.load(SIGNATURES_PATH);
+        m_signatures.add(signatures::DEFAULT);
+        m_signatures.resolve(m_game_module);
+
+        m_xrefs = utility::XrefIndex::create(m_game_module);
+        sdk::REGlobalContext::update_pointers();
+        // Only finds where the globals are registered in the code, their slots aren't read until a refresh.
+        m_globals = std::make_unique<REGlobals>();
+    }
+    catch (const std::exception& e) {
+        spdlog::error("Failed to pre-warm game data: {}", e.what());
+        m_valid = false;
+        m_prewarm_done.set_exception(std::current_exception());
+        return;
+    }
+    catch (...) {
+        spdlog::error("Failed to pre-warm game data");
+        m_valid = false;
+        m_prewarm_done.set_exception(std::current_exception());
+        return;
+    }
+
+    spdlog::info("Finished pre-warming game data");
+
+    m_prewarm_done.set_value();
+}
+
+bool REFramework::wait_for_prewarm() {
+    try {
+        m_prewarmed.get();
+        return true;
+    }
+    catch (const std::exception& e) {
+        m_error = std::string{ "Failed to pre-warm game data: " } + e.what();
+    }
+    catch (...) {
+        m_error = "Failed to pre-warm game data.";
+    }
+
+    m_game_data_initialized = true;
+
+    return false;
+}
+
 void REFramework::on_frame() {
     if (!m_initialized) {
         if (!initialize()) {
@@ -63,11 +116,14 @@ void REFramework::on_frame() {
         return;
     }
 
+    update_keyboard_state();
+
     ImGui_ImplDX11_NewFrame();
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
 
     if (m_error.empty() && m_game_data_initialized) {
+        apply_config_reload();
         m_mods->on_frame();
     }
 
@@ -75,6 +131,13 @@ void REFramework::on_frame() {
     ImGui::EndFrame();
     ImGui::Render();
 
+    // ImGui copied everything it needed into its draw lists.
+    m_frame_arena.reset();
+
+#ifdef INSTRUMENTED
+    utility::instrumentation::end_frame();
+#endif
+
     ID3D11DeviceContext *context = nullptr;
     m_d3d11_hook->get_device()->GetImmediateContext(&context);
 
@@ -105,10 +168,27 @@ bool REFramework::on_message(HWND wnd, UINT message, WPARAM w_param, LPARAM l_pa
     return true;
 }
 
-// this is unfortunate.
+// Called on the game's input thread, so this must never wait on the render thread.
 void REFramework::on_direct_input_keys(const std::array<uint8_t, 256> &keys) {
-    if (keys[m_menu_key] && m_last_keys[m_menu_key] == 0) {
-        std::lock_guard _{m_input_mutex};
+    for (size_t k = 0; k < keys.size(); ++k) {
+        if (keys[k] != 0 && m_input_state.keys[k] == 0) {
+            ++m_input_state.presses[k];
+        }
+    }
+
+    m_input_state.keys = keys;
+
+    m_keyboard.back() = m_input_state;
+    m_keyboard.publish();
+}
+
+void REFramework::update_keyboard_state() {
+    m_keyboard_state = &m_keyboard.front();
+
+    auto menu_key_presses = m_keyboard_state->presses[m_menu_key];
+
+    if (menu_key_presses != m_menu_key_presses) {
+        m_menu_key_presses = menu_key_presses;
         m_draw_ui = !m_draw_ui;
 
         // Save the config if we close the UI
@@ -116,30 +196,98 @@ void REFramework::on_direct_input_keys(const std::array<uint8_t, 256> &keys) {
             save_config();
         }
     }
-
-    m_last_keys = keys;
 }
 
 void REFramework::save_config() {
-    spdlog::info("Saving config re2_fw_config.txt");
+    auto &values = IModValue::get_registry();
 
-    utility::Config cfg{};
+    if (std::none_of(values.begin(), values.end(), [](IModValue *value) { return value->is_dirty(); })) {
+        return;
+    }
 
-    for (auto &mod : m_mods->get_mods()) {
-        mod->on_config_save(cfg);
+    spdlog::info("Saving config {}", CONFIG_PATH);
+
+    // Values are stored typed so building this is cheap, formatting and disk I/O happen on the writer's thread.
+    m_config_writer->post(build_config());
+
+    for (auto value : values) {
+        value->mark_clean();
     }
+}
 
-    if (!cfg.save("re2_fw_config.txt")) {
-        spdlog::info("Failed to save config");
+void REFramework::export_config() {
+    spdlog::info("Exporting config to {}", CONFIG_TEXT_PATH);
+
+    m_config_exporter->post(build_config());
+}
+
+void REFramework::start_config_watcher() {
+    // Either what was just imported, or older than the binary config and only edits from here on count.
+    m_watched_config = std::make_shared<const utility::Config>(CONFIG_TEXT_PATH);
+
+    m_config_watcher = utility::FileWatcher::create(CONFIG_TEXT_PATH, [reloads = m_config_reloads]() {
+        reloads->back() = std::make_shared<const utility::Config>(CONFIG_TEXT_PATH);
+        reloads->publish();
+    });
+}
+
+// Runs at the start of a frame, so mods never see values change halfway through one.
+void REFramework::apply_config_reload() {
+    auto snapshot = m_config_reloads->front();
+
+    if (snapshot == nullptr || snapshot == m_watched_config) {
+        return;
+    }
+
+    utility::Config changed{};
+    auto &old_values = m_watched_config->get_key_values();
+
+    for (auto &[key, value] : snapshot->get_key_values()) {
+        auto it = old_values.find(key);
+
+        if (it == old_values.end() || it->second != value) {
+            changed.get_key_values().emplace(key, value);
+        }
+    }
+
+    m_watched_config = std::move(snapshot);
+
+    if (changed.get_key_values().empty()) {
         return;
     }
 
-    spdlog::info("Saved config");
+    spdlog::info("{} changed, reloading {} values", CONFIG_TEXT_PATH, changed.get_key_values().size());
+
+    // Values not in the config are left alone, so only the changed ones get touched.
+    for (auto value : IModValue::get_registry()) {
+        value->config_load(changed);
+    }
+
+    for (auto &mod : m_mods->get_mods()) {
+        INSTRUMENT_CALLBACK(*mod, ON_CONFIG_LOAD);
+        mod->on_config_load(changed);
+    }
+
+    // Keep the binary config in step with what was just loaded.
+    m_config_writer->post(build_config());
 }
 
-void REFramework::draw_ui() {
-    std::lock_guard _{m_input_mutex};
+utility::Config REFramework::build_config() {
+    utility::Config cfg{};
+
+    for (auto value : IModValue::get_registry()) {
+        value->config_save(cfg);
+    }
+
+    for (auto &mod : m_mods->get_mods()) {
+        INSTRUMENT_CALLBACK(*mod, ON_CONFIG_SAVE);
+        mod->on_config_save(cfg);
+    }
 
+    return cfg;
+}
+
+void REFramework::draw_ui() {
     if (!m_draw_ui) {
         m_dinput_hook->acknowledge_input();
         ImGui::GetIO().MouseDrawCursor = false;
@@ -162,6 +310,10 @@ void REFramework::draw_ui() {
     ImGui::Begin("RE2 Speedrun Overlay", &m_draw_ui);
     ImGui::Text("Menu Key: Insert");
 
+    if (m_game_data_initialized && ImGui::Button("Export Config as Text")) {
+        export_config();
+    }
+
     draw_about();
 
     if (m_error.empty() && m_game_data_initialized) {
@@ -271,8 +423,12 @@ bool REFramework::initialize() {
 
         // Game specific initialization stuff
         std::thread init_thread([this]() {
+            if (!wait_for_prewarm()) {
+                return;
+            }
+
+            // Not in prewarm, the engine is still filling and growing the type list while it boots.
             m_types = std::make_unique<RETypes>();
-            m_globals = std::make_unique<REGlobals>();
             m_mods = std::make_unique<Mods>();
 
             auto e = m_mods->on_initialize();
@@ -283,6 +439,8 @@ bool REFramework::initialize() {
                 } else {
                     m_error = *e;
                 }
+            } else {
+                start_config_watcher();
             }
 
             m_game_data_initialized = true;
@@ -441,8 +599,12 @@ bool REFramework::initialize_dx12() {
 
         // Game specific initialization stuff
         std::thread init_thread([this]() {
+            if (!wait_for_prewarm()) {
+                return;
+            }
+
+            // Not in prewarm, the engine is still filling and growing the type list while it boots.
             m_types = std::make_unique<RETypes>();
-            m_globals = std::make_unique<REGlobals>();
             m_mods = std::make_unique<Mods>();
 
             auto e = m_mods->on_initialize();
@@ -453,6 +615,8 @@ bool REFramework::initialize_dx12() {
                 } else {
                     m_error = *e;
                 }
+            } else {
+                start_config_watcher();
             }
 
             m_game_data_initialized = true;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <future>
+
 #include <spdlog/spdlog.h>
 #include <imgui.h>
 
@@ -7,16 +9,42 @@ class Mods;
 class REGlobals;
 class RETypes;
 
+#include "utility/Config.hpp"
+#include "utility/FileWatcher.hpp"
+#include "utility/FrameArena.hpp"
+#include "utility/SignatureDatabase.hpp"
+#include "utility/TripleBuffer.hpp"
+#include "utility/XrefIndex.hpp"
+
 #include "D3D11Hook.hpp"
 #include "WindowsMessageHook.hpp"
 #include "DInputHook.hpp"
 
+// What DInputHook last saw of the keyboard. presses counts every key down edge,
+// so a reader comparing against the count it saw last never misses a press between frames.
+struct KeyboardState {
+    std::array<uint8_t, 256> keys{};
+    std::array<uint32_t, 256> presses{};
+};
+
 // Global facilitator
 class REFramework {
 public:
+    // The binary config is what gets loaded and saved, the text one is exported on request and
+    // imported when it's been edited since the binary one was written.
+    static constexpr auto CONFIG_PATH{ "re2_fw_config.bin" };
+    static constexpr auto CONFIG_TEXT_PATH{ "re2_fw_config.txt" };
+    // Optional, signatures in it are tried before the built in ones.
+    static constexpr auto SIGNATURES_PATH{ "re2_fw_signatures.txt" };
+
     REFramework();
     virtual ~REFramework();
 
+    // Resolves the signature database and builds the xref and global indices. Only needs the module image,
+    // so the startup thread runs it while the game is still booting and the game data
+    // initialization on the first present just waits for it to finish.
+    void prewarm();
+
     bool is_valid() const {
         return m_valid;
     }
@@ -29,14 +57,34 @@ public:
         return m_types;
     }
 
+    // Snapshot taken at the start of the current frame, only read it from the render thread.
     const auto& get_keyboard_state() const {
-        return m_last_keys;
+        return m_keyboard_state->keys;
+    }
+
+    const auto& get_keyboard() const {
+        return *m_keyboard_state;
     }
 
     const auto& get_globals() const {
         return m_globals;
     }
 
+    // Built by prewarm, nullptr until then.
+    const auto& get_xrefs() const {
+        return m_xrefs;
+    }
+
+    // Scratch memory for the current frame, reset once it's rendered. Render thread only.
+    auto& get_frame_arena() {
+        return m_frame_arena;
+    }
+
+    // Resolved by prewarm, nothing is found until then.
+    const auto& get_signatures() const {
+        return m_signatures;
+    }
+
     Address get_module() const {
         return m_game_module;
     }
@@ -54,33 +102,59 @@ public:
     void on_direct_input_keys(const std::array<uint8_t, 256>& keys);
 
     void save_config();
+    void export_config();
     static void setup_style(ImGuiStyle &st);
     static void draw_about();
 
 private:
     void draw_ui();
     void draw_ui_dx12();
+    void update_keyboard_state();
+    utility::Config build_config();
+    void start_config_watcher();
+    void apply_config_reload();
+    // Blocks until prewarm is done. If it failed, sets m_error and returns false.
+    bool wait_for_prewarm();
     bool initialize();
     void create_render_target();
     void cleanup_render_target();
 
     bool m_first_frame{ true };
-    bool m_valid{ false };
+    // Cleared by prewarm on the startup thread if it fails.
+    std::atomic<bool> m_valid{ false };
     bool m_initialized{ false };
     bool m_draw_ui{ false };
     std::atomic<bool> m_game_data_initialized{ false };
 
-    std::mutex m_input_mutex{};
-    
     HWND m_wnd{ 0 };
     HMODULE m_game_module{ 0 };
     uint8_t m_menu_key{ DIK_INSERT };
 
-    std::array<uint8_t, 256> m_last_keys{ 0 };
+    // Owned by the input thread.
+    KeyboardState m_input_state{};
+    // Handed from the input thread to the render thread without either side blocking.
+    utility::TripleBuffer<KeyboardState> m_keyboard{};
+    // Owned by the render thread.
+    const KeyboardState* m_keyboard_state{ &m_keyboard.front() };
+    uint32_t m_menu_key_presses{ 0 };
+
+    utility::FrameArena m_frame_arena{};
+
     std::unique_ptr<D3D11Hook> m_d3d11_hook{};
     std::unique_ptr<WindowsMessageHook> m_windows_message_hook;
     std::unique_ptr<DInputHook> m_dinput_hook;
     std::shared_ptr<spdlog::logger> m_logger;
+    std::unique_ptr<utility::ConfigWriter> m_config_writer;
+    std::unique_ptr<utility::ConfigWriter> m_config_exporter;
+
+    using ConfigSnapshot = std::shared_ptr<const utility::Config>;
+
+    // Edits to the text config are parsed on the watcher's thread and handed over here,
+    // shared with the watcher's callback so it never touches REFramework itself.
+    utility::FileWatcher::Ptr m_config_watcher{};
+    std::shared_ptr<utility::TripleBuffer<ConfigSnapshot>> m_config_reloads{ std::make_shared<utility::TripleBuffer<ConfigSnapshot>>() };
+    // The text config as of the last reload, changes are applied relative to it. Render thread only.
+    ConfigSnapshot m_watched_config{};
 
     std::string m_error{ "" };
 
@@ -88,6 +162,13 @@ private:
     std::unique_ptr<Mods> m_mods;
     std::unique_ptr<REGlobals> m_globals;
     std::unique_ptr<RETypes> m_types;
+    std::unique_ptr<utility::XrefIndex> m_xrefs;
+    utility::SignatureDatabase m_signatures{};
+
+    // Set once prewarm has resolved m_signatures and built m_xrefs and m_globals,
+    // or holds what it threw if it couldn't.
+    std::promise<void> m_prewarm_done{};
+    std::shared_future<void> m_prewarmed{ m_prewarm_done.get_future().share() };
 
     ID3D11RenderTargetView* m_main_render_target_view{ nullptr };
 };
@@ -0,0 +1,86 @@
+#include <thread>
+
+#include <imgui/imgui.h>
+
+#include "REFramework.hpp"
+#include "SignatureTool.hpp"
+
+void SignatureTool::on_draw_ui() {
+    ImGui::SetNextTreeNodeOpen(false, ImGuiCond_::ImGuiCond_Once);
+
+    if (!ImGui::CollapsingHeader(get_name().data())) {
+        return;
+    }
+
+    auto index = get_index();
+
+    if (index == nullptr) {
+        std::lock_guard _{ m_state->mutex };
+
+        if (m_state->building) {
+            ImGui::Text("Building index...");
+        }
+        else if (ImGui::Button("Build Index")) {
+            build_index();
+        }
+
+        return;
+    }
+
+    ImGui::InputText("Address", m_address.data(), m_address.size(), ImGuiInputTextFlags_::ImGuiInputTextFlags_CharsHexadecimal);
+
+    if (ImGui::Button("Generate") && m_address[0] != 0) {
+        auto signature = index->make_signature(std::stoull(m_address.data(), nullptr, 16));
+        m_signature = signature ? *signature : "No unique signature";
+    }
+
+    if (!m_signature.empty()) {
+        ImGui::TextUnformatted(m_signature.c_str());
+        ImGui::SameLine();
+
+        if (ImGui::Button("Copy")) {
+            ImGui::SetClipboardText(m_signature.c_str());
+        }
+    }
+
+    ImGui::InputText("Pattern", m_pattern.data(), m_pattern.size());
+
+    if (ImGui::Button("Find")) {
+        // Enough to tell whether a pattern is unique without listing half the module.
+        auto matches = index->find_all(m_pattern.data(), 16);
+
+        m_matches.clear();
+
+        for (auto match : matches) {
+            m_matches += fmt::format("{:x}\n", match);
+        }
+
+        if (matches.size() == 1) {
+            m_matches += "Unique";
+        }
+        else if (matches.empty()) {
+            m_matches = "No matches";
+        }
+    }
+
+    ImGui::TextUnformatted(m_matches.c_str());
+}
+
+void SignatureTool::build_index() {
+    m_state->building = true;
+
+    std::thread{ [state = m_state, module = g_framework->get_module().as<HMODULE>()]() {
+        auto index = utility::SignatureIndex::create(module);
+
+        std::lock_guard _{ state->mutex };
+        state->index = std::move(index);
+        state->building = false;
+    } }.detach();
+}
+
+const utility::SignatureIndex* SignatureTool::get_index() const {
+    std::lock_guard _{ m_state->mutex };
+
+    // Never replaced once built, so the pointer stays good outside the lock.
+    return m_state->index.get();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+
+#include "utility/SignatureIndex.hpp"
+
+#include "Mod.hpp"
+
+// Generates signatures for addresses in the game and checks how many places a pattern matches.
+class SignatureTool : public Mod {
+public:
+    std::string_view get_name() const override { return "SignatureTool"; };
+
+    void on_draw_ui() override;
+
+private:
+    // Shared with the thread building the index, so it never has to outlive the tool.
+    struct State {
+        std::mutex mutex{};
+        utility::SignatureIndex::Ptr index{};
+        bool building{ false };
+    };
+
+    void build_index();
+    const utility::SignatureIndex* get_index() const;
+
+    std::shared_ptr<State> m_state{ std::make_shared<State>() };
+
+    std::array<char, 17> m_address{};
+    std::array<char, 256> m_pattern{};
+    std::string m_signature{};
+    std::string m_matches{};
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+// The signatures the framework and its mods look things up with, see utility::SignatureDatabase
+// for the format. Entries in re2_fw_signatures.txt are tried before these.
+namespace signatures {
+    static constexpr auto DEFAULT =
+R"(# name                   build   resolve  offset  pattern
+
+# Version 1.0 jmp stub: game+0x1dc7de0
+# Version 2 Dec 17th, 2019 game.exe+0x1DD3FF0 (works on old version too)
+# Can be found by breakpointing RETransform's worldTransform
+UpdateTransform           v2      call     0       E8 ? ? ? ? 48 8B 5B ? 48 85 DB 75 ? 48 8B 4D 40 48 ? ?
+
+# Version 1.0 jmp stub: game+0xB4685A0
+# Version 2 Dec 17th, 2019 game.exe+0x7CF690 (works on old version too)
+# Can be found by breakpointing camera controller's worldPosition
+UpdateCameraController    v2      address  0       40 55 56 57 48 8D AC 24 ? ? ? ? 48 81 EC ? ? 00 00 48 8B 41 50
+UpdateCameraController    v1      call     8       75 ? 48 89 FA 48 89 D9 E8 ? ? ? ? 48 8B 43 50 48 83 78 18 00 75 ? 45 89
+
+# Version 1.0 jmp stub: game+0xCF2510
+# Version 1.0 function: game+0xB436230
+# Version 2 Dec 17th, 2019 game.exe+0x6CD9C0 (works on old version too)
+# Can be found by breakpointing camera controller's worldRotation
+UpdateCameraController2   v2      address  0       40 53 57 48 81 EC ? ? ? ? 48 ? ? ? 48 ? ? 48 ? ? ? ? 00 00
+
+# Version 2 Dec 17th, 2019, first ptr is at game.exe+0x7095E08
+GlobalContext             v2      rip      3       48 8B 0D ? ? ? ? BA FF FF FF FF E8 ? ? ? ?
+GetThreadContext          v2      call     12      48 8B 0D ? ? ? ? BA FF FF FF FF E8 ? ? ? ?
+
+TypeList                  v2      rip      3       48 8D 0D ? ? ? ? E8 ? ? ? ? 48 8D 05 ? ? ? ? 48 89 03
+EnumList                  v2      rip      9       66 C7 40 18 01 01 48 89 05 ? ? ? ?
+
+# Assignments of the integrity check boolean, referenced above "steam_api64.dll"
+#   cmp     qword ptr [rax+18h], 0
+#   cmovz   ecx, r15d
+#   mov     cs:bypass_integrity_checks, cl
+# The longer pattern came second and took precedence when both matched, so it's tried first.
+BypassIntegrityChecks     b       rip      10      48 ? ? 18 00 0F ? ? 88 0D ? ? ? ? 49 ? ? ? 48
+BypassIntegrityChecks     a       rip      11      48 ? ? 18 00 41 ? ? ? 88 0D ? ? ? ?
+
+# Version 2 Dec 17th, 2019 game.exe+0x20437C (works on old version too)
+# Cleanup the game does after a script exception, in the order it calls them.
+ThreadContextCleanup1     v2      call     10      48 83 78 18 00 74 ? 48 ? ? E8 ? ? ? ? 48 ? ? E8 ? ? ? ?
+ThreadContextCleanup2     v2      call     18      48 83 78 18 00 74 ? 48 ? ? E8 ? ? ? ? 48 ? ? E8 ? ? ? ?
+ThreadContextCleanup3     v2      call     26      48 83 78 18 00 74 ? 48 ? ? E8 ? ? ? ? 48 ? ? E8 ? ? ? ?
+)";
+}
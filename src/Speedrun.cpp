@@ -1,23 +1,28 @@
 #include "REFramework.hpp"
 #include "Speedrun.h"
-#include <iomanip>
-#include <sstream>
 #include <chrono>
 #include <utility>
 
-const static std::stringstream &display(std::stringstream &os, std::chrono::nanoseconds ns) {
-    char fill = os.fill();
-    os.fill('0');
+static constexpr char GAME_CLOCK[]{ GAME_NAMESPACE "GameClock" };
+static constexpr char PLAYER_MANAGER[]{ GAME_NAMESPACE "PlayerManager" };
+static constexpr char GAME_RANK_SYSTEM[]{ GAME_NAMESPACE "GameRankSystem" };
+static constexpr char ENEMY_MANAGER[]{ GAME_NAMESPACE "EnemyManager" };
+static constexpr char MAIN_FLOW_MANAGER[]{ GAME_NAMESPACE "gamemastering.MainFlowManager" };
+
+static GlobalHandle<REBehavior, GAME_CLOCK> g_game_clock{};
+static GlobalHandle<REBehavior, PLAYER_MANAGER> g_player_manager{};
+static GlobalHandle<REBehavior, GAME_RANK_SYSTEM> g_game_rank_system{};
+static GlobalHandle<RopewayEnemyManager, ENEMY_MANAGER> g_enemy_manager{};
+static GlobalHandle<REBehavior, MAIN_FLOW_MANAGER> g_main_flow_manager{};
+
+static utility::FrameString display(std::chrono::nanoseconds ns) {
     auto h = std::chrono::duration_cast<std::chrono::hours>(ns);
     ns -= h;
     auto m = std::chrono::duration_cast<std::chrono::minutes>(ns);
     ns -= m;
     auto s = std::chrono::duration_cast<std::chrono::seconds>(ns);
-    os << std::setw(2) << h.count() << "h:"
-       << std::setw(2) << m.count() << "m:"
-       << std::setw(2) << s.count() << 's';
-    os.fill(fill);
-    return os;
+
+    return g_framework->get_frame_arena().format("{:02}h:{:02}m:{:02}s", h.count(), m.count(), s.count());
 }
 
 static std::chrono::nanoseconds get_nanos(REManagedObject *bh, const std::string &key) {
@@ -86,28 +91,7 @@ void Speedrun::on_draw_ui() {
     }
 }
 
-void Speedrun::on_config_load(const utility::Config &cfg) {
-    enabled->config_load(cfg);
-    ingame->config_load(cfg);
-    health->config_load(cfg);
-    game_rank->config_load(cfg);
-    local_enemies->config_load(cfg);
-    reset_btn->config_load(cfg);
-    lod_params->config_load(cfg);
-}
-
-void Speedrun::on_config_save(utility::Config &cfg) {
-    enabled->config_save(cfg);
-    ingame->config_save(cfg);
-    health->config_save(cfg);
-    game_rank->config_save(cfg);
-    local_enemies->config_save(cfg);
-    reset_btn->config_save(cfg);
-    lod_params->config_save(cfg);
-}
-
 void Speedrun::draw_stats() {
-    auto &globals = *g_framework->get_globals();
     ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowSize(ImVec2(500, 500), ImGuiCond_FirstUseEver);
     ImGui::Begin("", &enabled->value(), window_flags(locked->value()));
@@ -122,26 +106,22 @@ void Speedrun::draw_stats() {
         switch (i) {
             case 1:
                 if (ingame->value()) {
-                    auto clock = globals.get<REBehavior>(game_namespace("GameClock"));
-                    draw_ingame_time(clock);
+                    draw_ingame_time(g_game_clock.get());
                 }
                 continue;
             case 2:
                 if (health->value()) {
-                    auto player = globals.get<REBehavior>(game_namespace("PlayerManager"));
-                    draw_health(player, health_bar->value());
+                    draw_health(g_player_manager.get(), health_bar->value());
                 }
                 continue;
             case 3:
                 if (game_rank->value()) {
-                    auto rank = globals.get<REBehavior>(game_namespace("GameRankSystem"));
-                    draw_game_rank(rank);
+                    draw_game_rank(g_game_rank_system.get());
                 }
                 continue;
             case 4:
                 if (local_enemies->value()) {
-                    auto enemy_manager = globals.get<RopewayEnemyManager>(game_namespace("EnemyManager"));
-                    draw_enemies(enemy_manager, colored_buttons->value());
+                    draw_enemies(g_enemy_manager.get(), colored_buttons->value());
                 }
                 continue;
             default:
@@ -159,12 +139,8 @@ void Speedrun::draw_ingame_time(REBehavior *clock) {
     auto actual_time_nanos = get_nanos(clock, "ActualRecordTime");
     auto inv_time_nanos = get_nanos(clock, "InventorySpendingTime");
 
-    std::stringstream os;
-    auto o = display(os, actual_time_nanos).str();
-    ImGui::LabelText("Game Time", "%s", o.data());
-    os = std::stringstream();
-    o = display(os, inv_time_nanos).str();
-    ImGui::LabelText("Inventory Time", "%s", o.data());
+    ImGui::LabelText("Game Time", "%s", display(actual_time_nanos).data());
+    ImGui::LabelText("Inventory Time", "%s", display(inv_time_nanos).data());
 }
 
 void Speedrun::draw_health(REBehavior *player, const bool draw_health) {
@@ -191,8 +167,10 @@ void Speedrun::draw_enemies(RopewayEnemyManager *enemy_manager, const bool draw_
     auto enemy_controllers = Address((uintptr_t) enemy_manager).get(0x78).to<DotNetGenericList *>();
     if (enemy_controllers != nullptr && enemy_controllers->data != nullptr) {
         ImGui::Columns(COLUMNS, "Health", false);
-        for (auto i = 0; i < enemy_controllers->data->numElements; ++i) {
-            auto ec = utility::re_array::get_element<RopewayEnemyController>(enemy_controllers->data, i);
+        utility::re_array::REArrayView<RopewayEnemyController> enemies{ enemy_controllers->data };
+        for (auto it = enemies.begin(); it != enemies.end(); ++it) {
+            auto i = it.index();
+            auto ec = *it;
             REBehavior *hitpoint_controller = nullptr;
             if (ec == nullptr) break;
             if (!utility::re_managed_object::is_managed_object(ec)) continue;
@@ -221,8 +199,10 @@ void Speedrun::draw_enemies(RopewayEnemyManager *enemy_manager, const bool draw_
         auto enemy_controllers = enemy_manager->enemyControllers;
         if (enemy_controllers != nullptr && enemy_controllers->data != nullptr) {
             ImGui::Columns(COLUMNS, "Health", false);
-            for (auto i = 0; i < enemy_controllers->data->numElements; ++i) {
-                auto ec = utility::re_array::get_element<RopewayEnemyController>(enemy_controllers->data, i);
+            utility::re_array::REArrayView<RopewayEnemyController> enemies{ enemy_controllers->data };
+            for (auto it = enemies.begin(); it != enemies.end(); ++it) {
+                auto i = it.index();
+                auto ec = *it;
                 REBehavior *hitpoint_controller = nullptr;
                 if (ec == nullptr) break;
                 if (!utility::re_managed_object::is_managed_object(ec)) continue;
@@ -248,8 +228,7 @@ void Speedrun::draw_enemies(RopewayEnemyManager *enemy_manager, const bool draw_
 #endif
 
 void Speedrun::reset() {
-    auto &globals = *g_framework->get_globals();
-    auto rank = globals.get<REBehavior>(game_namespace("gamemastering.MainFlowManager"));
+    auto rank = g_main_flow_manager.get();
     auto in_game = utility::re_managed_object::get_field<signed int>(rank, "IsInGame");
     auto game_over = utility::re_managed_object::get_field<signed int>(rank, "IsInGameOver");
     auto reset_title = utility::re_managed_object::get_field<signed int>(rank, "IsInResetTitle");
@@ -16,10 +16,6 @@ public:
 
     void on_draw_ui() override;
 
-    void on_config_load(const utility::Config &cfg) override;
-
-    void on_config_save(utility::Config &cfg) override;
-
     void draw_stats();
 
     static void reset();
@@ -51,7 +47,7 @@ public:
         const ImColor color = create_color(ratio);
         if (draw_bg) {
             ImGui::PushStyleColor(ImGuiCol_Button, (ImU32) color);
-            ImGui::Button(fmt::format("{:.0%}", ratio).data(), ImVec2(70, 30));
+            ImGui::Button(g_framework->get_frame_arena().format("{:.0f}%", ratio * 100.0f).data(), ImVec2(70, 30));
             ImGui::PopStyleColor(1);
         } else {
             ImGui::TextColored(color, "%.0f%%", ratio * 100.0);
@@ -0,0 +1,399 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <spdlog/spdlog.h>
+
+#include "REFramework.hpp"
+#include "TransformRecorder.hpp"
+
+static constexpr char PLAYER_MANAGER[]{ GAME_NAMESPACE "PlayerManager" };
+static constexpr char ENEMY_MANAGER[]{ GAME_NAMESPACE "EnemyManager" };
+
+static GlobalHandle<REBehavior, PLAYER_MANAGER> g_player_manager{};
+static GlobalHandle<RopewayEnemyManager, ENEMY_MANAGER> g_enemy_manager{};
+
+static constexpr auto RECORDING_PATH{ "re2_fw_transforms.bin" };
+
+static void write_varint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back((uint8_t)value);
+}
+
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static DotNetGenericList* get_enemy_controllers(RopewayEnemyManager* enemy_manager) {
+    if (enemy_manager == nullptr) {
+        return nullptr;
+    }
+
+#ifdef RE3
+    return Address((uintptr_t)enemy_manager).get(0x78).to<DotNetGenericList*>();
+#else
+    return enemy_manager->enemyControllers;
+#endif
+}
+
+TransformRecorder::TransformRecorder() {
+    m_pending.reserve(MAX_TRACKED);
+    m_enemies.reserve(MAX_TRACKED);
+    m_next_enemies.reserve(MAX_TRACKED);
+}
+
+TransformRecorder::~TransformRecorder() {
+    stop();
+}
+
+void TransformRecorder::on_frame() {
+    if (m_enabled->value() != m_running.load()) {
+        if (m_enabled->value()) {
+            if (!start()) {
+                m_enabled->value() = false;
+            }
+        }
+        else {
+            stop();
+        }
+    }
+
+    if (!m_running) {
+        return;
+    }
+
+    m_frame.fetch_add(1, std::memory_order_relaxed);
+    update_tracked();
+}
+
+void TransformRecorder::on_draw_ui() {
+    ImGui::SetNextTreeNodeOpen(false, ImGuiCond_::ImGuiCond_FirstUseEver);
+
+    if (!ImGui::CollapsingHeader(get_name().data())) {
+        return;
+    }
+
+    m_enabled->draw("Enabled");
+    m_record_player->draw("Record Player");
+    m_record_enemies->draw("Record Enemies");
+
+    if (!m_running) {
+        m_ring_size_mb->draw("Ring Size (MB)");
+        m_ring_size_mb->value() = std::clamp(m_ring_size_mb->value(), 1, MAX_RING_SIZE_MB);
+    }
+
+    ImGui::Text("File: %s", RECORDING_PATH);
+    ImGui::Text("Tracked transforms: %i", (int)m_num_tracked.load());
+    ImGui::Text("Frames written: %llu", m_frames_written.load());
+    ImGui::Text("Dropped samples: %llu", m_dropped.load());
+}
+
+void TransformRecorder::on_update_transform(RETransform* transform) {
+    if (!m_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    if ((m_filter.load(std::memory_order_relaxed) & get_filter_bit(transform)) == 0) {
+        return;
+    }
+
+    auto num_tracked = m_num_tracked.load(std::memory_order_acquire);
+
+    for (size_t i = 0; i < num_tracked; ++i) {
+        if (m_tracked[i].load(std::memory_order_relaxed) != transform) {
+            continue;
+        }
+
+        Sample sample{};
+        sample.frame = m_frame.load(std::memory_order_relaxed);
+        sample.transform = transform;
+        sample.slot = (uint32_t)i;
+        sample.world = transform->worldTransform;
+        sample.position = transform->position;
+        sample.angles = transform->angles;
+
+        if (!m_queue.push(sample)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return;
+    }
+}
+
+bool TransformRecorder::start() {
+    // The config can hold anything, not just what the UI allows.
+    const auto data_capacity = (uint64_t)std::clamp(m_ring_size_mb->value(), 1, MAX_RING_SIZE_MB) * 1024 * 1024;
+    const auto index_offset = (uint64_t)sizeof(FileHeader);
+    const auto data_offset = index_offset + INDEX_CAPACITY * sizeof(IndexRecord);
+
+    m_file = utility::MappedFile::open(RECORDING_PATH, data_offset + data_capacity);
+
+    if (m_file == nullptr) {
+        spdlog::error("[{:s}] Failed to open {:s}", get_name().data(), RECORDING_PATH);
+        return false;
+    }
+
+    // Start from a clean file every time, old index records would otherwise point into the new data.
+    memset(m_file->get_data(), 0, data_offset);
+
+    auto header = (FileHeader*)m_file->get_data();
+    header->magic = MAGIC;
+    header->version = VERSION;
+    header->index_offset = index_offset;
+    header->index_capacity = INDEX_CAPACITY;
+    header->keyframe_interval = KEYFRAME_INTERVAL;
+    header->data_offset = data_offset;
+    header->data_capacity = data_capacity;
+
+    // Drop anything a hook pushed after the last recording stopped.
+    for (Sample sample{}; m_queue.pop(sample);) {
+    }
+
+    m_slots = {};
+    m_pending.clear();
+    m_frames_written = 0;
+    m_dropped = 0;
+
+    m_running = true;
+    m_writer = std::thread{ &TransformRecorder::writer_thread, this };
+    m_recording = true;
+
+    spdlog::info("[{:s}] Recording to {:s}", get_name().data(), RECORDING_PATH);
+
+    return true;
+}
+
+void TransformRecorder::stop() {
+    m_recording = false;
+    m_num_tracked = 0;
+    m_filter = 0;
+    m_enemies.clear();
+
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+
+    m_file->flush();
+    m_file.reset();
+}
+
+void TransformRecorder::update_tracked() {
+    std::array<RETransform*, MAX_TRACKED> tracked{};
+    size_t num_tracked = 0;
+
+    auto add = [&](REGameObject* game_object) {
+        if (num_tracked >= MAX_TRACKED || game_object == nullptr || game_object->transform == nullptr) {
+            return;
+        }
+
+        tracked[num_tracked++] = game_object->transform;
+    };
+
+    if (m_record_player->value()) {
+        if (auto player_manager = g_player_manager.get(); player_manager != nullptr) {
+            add(utility::re_managed_object::get_field<REGameObject*>(player_manager, "CurrentPlayer"));
+        }
+    }
+
+    m_next_enemies.clear();
+
+    if (m_record_enemies->value()) {
+        auto enemy_controllers = get_enemy_controllers(g_enemy_manager.get());
+
+        if (enemy_controllers != nullptr && enemy_controllers->data != nullptr) {
+            for (auto ec : utility::re_array::REArrayView<RopewayEnemyController>{ enemy_controllers->data }) {
+                if (ec == nullptr || m_next_enemies.size() >= MAX_TRACKED) {
+                    continue;
+                }
+
+                auto it = std::find_if(m_enemies.begin(), m_enemies.end(), [&](const EnemyHandle& handle) {
+                    return handle.get_address() == ec;
+                });
+
+                auto handle = it != m_enemies.end() ? *it : EnemyHandle{ ec };
+                auto enemy = handle.get();
+
+                if (enemy == nullptr) {
+                    continue;
+                }
+
+                add(enemy->ownerGameObject);
+                m_next_enemies.push_back(handle);
+            }
+        }
+    }
+
+    std::swap(m_enemies, m_next_enemies);
+
+    uint64_t filter = 0;
+
+    for (size_t i = 0; i < num_tracked; ++i) {
+        m_tracked[i].store(tracked[i], std::memory_order_relaxed);
+        filter |= get_filter_bit(tracked[i]);
+    }
+
+    m_num_tracked.store(num_tracked, std::memory_order_release);
+    m_filter.store(filter, std::memory_order_relaxed);
+}
+
+void TransformRecorder::writer_thread() {
+    Sample sample{};
+
+    while (m_running) {
+        auto popped = false;
+
+        while (m_queue.pop(sample)) {
+            popped = true;
+            add_pending(sample);
+        }
+
+        // Nothing more can show up for the pending frame once the game has moved past it.
+        if (!m_pending.empty() && m_frame.load(std::memory_order_relaxed) > m_pending.front().frame + 1) {
+            write_frame();
+        }
+
+        if (!popped) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+    }
+
+    while (m_queue.pop(sample)) {
+        add_pending(sample);
+    }
+
+    write_frame();
+}
+
+void TransformRecorder::add_pending(Sample sample) {
+    if (!m_pending.empty() && sample.frame > m_pending.front().frame) {
+        write_frame();
+    }
+
+    if (!m_pending.empty()) {
+        // Late arrivals from a previous frame get folded into the one being built.
+        sample.frame = m_pending.front().frame;
+    }
+
+    // A transform updated more than once in a frame only keeps its last update.
+    auto it = std::find_if(m_pending.begin(), m_pending.end(), [&](const Sample& s) { return s.slot == sample.slot; });
+
+    if (it != m_pending.end()) {
+        *it = sample;
+    }
+    else {
+        m_pending.push_back(sample);
+    }
+}
+
+void TransformRecorder::encode_sample(const Sample& sample, bool keyframe) {
+    const auto& world = sample.world;
+    const auto scale = Vector3f{ glm::length(Vector3f{ world[0] }), glm::length(Vector3f{ world[1] }), glm::length(Vector3f{ world[2] }) };
+    const auto safe_scale = glm::max(scale, Vector3f{ 1e-6f });
+    auto rotation = glm::quat_cast(Matrix3x3f{ Vector3f{ world[0] } / safe_scale.x, Vector3f{ world[1] } / safe_scale.y, Vector3f{ world[2] } / safe_scale.z });
+
+    // q and -q are the same rotation, keep w positive so deltas don't jump between them.
+    if (rotation.w < 0.0f) {
+        rotation = -rotation;
+    }
+
+    const std::array<float, NUM_CHANNELS> channels{
+        world[3].x, world[3].y, world[3].z,
+        rotation.x, rotation.y, rotation.z, rotation.w,
+        scale.x, scale.y, scale.z,
+        sample.position.x, sample.position.y, sample.position.z,
+        sample.angles.x, sample.angles.y, sample.angles.z, sample.angles.w
+    };
+
+    auto& slot = m_slots[sample.slot];
+
+    m_block.push_back((uint8_t)sample.slot);
+    m_block.push_back(keyframe ? (uint8_t)KEYFRAME : 0);
+
+    for (size_t i = 0; i < NUM_CHANNELS; ++i) {
+        auto value = (int32_t)std::lround(channels[i] * CHANNEL_SCALES[i]);
+
+        // Differences are taken between quantized values so error doesn't build up over time.
+        write_varint(m_block, zigzag(keyframe ? value : value - slot.values[i]));
+        slot.values[i] = value;
+    }
+
+    slot.transform = sample.transform;
+    slot.last_frame = sample.frame;
+}
+
+void TransformRecorder::write_frame() {
+    if (m_pending.empty()) {
+        return;
+    }
+
+    const auto frame = m_pending.front().frame;
+    const auto force_keyframe = (frame % KEYFRAME_INTERVAL) == 0;
+    uint16_t flags = KEYFRAME;
+
+    m_block.resize(sizeof(FrameHeader));
+
+    for (auto& sample : m_pending) {
+        auto& slot = m_slots[sample.slot];
+
+        // A slot needs a keyframe whenever the decoder couldn't have its previous value.
+        auto keyframe = force_keyframe || slot.transform != sample.transform || slot.last_frame + 1 != frame;
+
+        if (!keyframe) {
+            flags = 0;
+        }
+
+        encode_sample(sample, keyframe);
+    }
+
+    auto header = (FileHeader*)m_file->get_data();
+    auto index = (IndexRecord*)(m_file->get_data() + header->index_offset);
+
+    FrameHeader frame_header{};
+    frame_header.frame = frame;
+    frame_header.size = (uint32_t)m_block.size();
+    frame_header.num_samples = (uint16_t)m_pending.size();
+    frame_header.flags = flags;
+    memcpy(m_block.data(), &frame_header, sizeof(frame_header));
+
+    const auto offset = header->write_pos;
+    write_ring(offset, m_block.data(), m_block.size());
+
+    // Invalidate the record first so a reader never pairs the old frame number with the new offset.
+    auto& record = index[frame % header->index_capacity];
+    record.frame = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    record.offset = offset;
+    record.size = frame_header.size;
+    record.num_samples = frame_header.num_samples;
+    record.flags = flags;
+
+    // Publish the frame number and write position last, a reader seeing them can trust everything before.
+    std::atomic_thread_fence(std::memory_order_release);
+    record.frame = frame;
+    header->last_frame = frame;
+    header->write_pos = offset + m_block.size();
+
+    m_pending.clear();
+    m_frames_written.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TransformRecorder::write_ring(uint64_t pos, const uint8_t* data, size_t size) {
+    auto header = (FileHeader*)m_file->get_data();
+    auto ring = m_file->get_data() + header->data_offset;
+    auto start = (size_t)(pos % header->data_capacity);
+    auto first = std::min<size_t>(size, header->data_capacity - start);
+
+    memcpy(ring + start, data, first);
+    memcpy(ring, data + first, size - first);
+}
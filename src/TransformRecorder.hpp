@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include "Mod.hpp"
+#include "utility/MappedFile.hpp"
+#include "utility/MpscQueue.hpp"
+
+// Records the player's and nearby enemies' transforms every frame into a ring file.
+// The transform hook only copies the transform into a queue, encoding and writing
+// happens on a separate thread.
+//
+// File layout:
+//   FileHeader
+//   IndexRecord[index_capacity], the record for frame N lives at N % index_capacity
+//   data ring of data_capacity bytes, made of frame blocks
+//
+// A frame block is a FrameHeader followed by num_samples samples. A sample is
+// the slot (1 byte), flags (1 byte) and NUM_CHANNELS zigzag varints.
+// Each channel is a float quantized with its CHANNEL_SCALES entry; keyframe samples
+// store the quantized value, others store the difference from the slot's previous sample.
+class TransformRecorder : public Mod {
+public:
+    // "RFTR"
+    static constexpr uint32_t MAGIC{ 0x52544652 };
+    static constexpr uint32_t VERSION{ 1 };
+
+    static constexpr size_t MAX_TRACKED{ 64 };
+    static constexpr uint32_t KEYFRAME_INTERVAL{ 60 };
+    static constexpr uint32_t INDEX_CAPACITY{ 1 << 16 };
+    static constexpr int32_t MAX_RING_SIZE_MB{ 4096 };
+
+    // World translation xyz, world rotation quaternion xyzw, world scale xyz, position xyz, angles xyzw.
+    static constexpr size_t NUM_CHANNELS{ 17 };
+    static constexpr std::array<float, NUM_CHANNELS> CHANNEL_SCALES{
+        1000.0f, 1000.0f, 1000.0f,
+        16384.0f, 16384.0f, 16384.0f, 16384.0f,
+        1024.0f, 1024.0f, 1024.0f,
+        1000.0f, 1000.0f, 1000.0f,
+        16384.0f, 16384.0f, 16384.0f, 16384.0f
+    };
+
+    enum Flags : uint16_t {
+        // For a frame, every sample in it is a keyframe so decoding can start there.
+        KEYFRAME = 1 << 0,
+    };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t index_offset;
+        uint32_t index_capacity;
+        uint32_t keyframe_interval;
+        uint64_t data_offset;
+        uint64_t data_capacity;
+        // Total bytes ever written to the data ring. Blocks starting before write_pos - data_capacity are gone.
+        uint64_t write_pos;
+        uint64_t last_frame;
+        char pad[16];
+    };
+
+    struct IndexRecord {
+        uint64_t frame;
+        // Position in the data ring, in the same units as FileHeader::write_pos.
+        uint64_t offset;
+        uint32_t size;
+        uint16_t num_samples;
+        uint16_t flags;
+    };
+
+    struct FrameHeader {
+        uint64_t frame;
+        uint32_t size;
+        uint16_t num_samples;
+        uint16_t flags;
+    };
+
+    TransformRecorder();
+    ~TransformRecorder() override;
+
+    std::string_view get_name() const override { return "TransformRecorder"; };
+
+    void on_frame() override;
+    void on_draw_ui() override;
+
+    void on_update_transform(RETransform* transform) override;
+
+private:
+    struct Sample {
+        uint64_t frame;
+        RETransform* transform;
+        uint32_t slot;
+        Matrix4x4f world;
+        Vector4f position;
+        Vector4f angles;
+    };
+
+    struct SlotState {
+        RETransform* transform{ nullptr };
+        uint64_t last_frame{ 0 };
+        std::array<int32_t, NUM_CHANNELS> values{};
+    };
+
+    static uint64_t get_filter_bit(const RETransform* transform) {
+        return 1ull << (((uintptr_t)transform >> 4) & 63);
+    }
+
+    bool start();
+    void stop();
+    void update_tracked();
+
+    void writer_thread();
+    void add_pending(Sample sample);
+    void encode_sample(const Sample& sample, bool keyframe);
+    void write_frame();
+    void write_ring(uint64_t pos, const uint8_t* data, size_t size);
+
+    const ModToggle::Ptr m_enabled{ ModToggle::create(generate_name("Enabled"), false) };
+    const ModToggle::Ptr m_record_player{ ModToggle::create(generate_name("RecordPlayer"), true) };
+    const ModToggle::Ptr m_record_enemies{ ModToggle::create(generate_name("RecordEnemies"), false) };
+    const ModInt32::Ptr m_ring_size_mb{ ModInt32::create(generate_name("RingSizeMB"), 64) };
+
+    // Written by the render thread, read by the transform hook.
+    std::array<std::atomic<RETransform*>, MAX_TRACKED> m_tracked{};
+    std::atomic<size_t> m_num_tracked{ 0 };
+    // One bit per tracked pointer hash, lets the hook skip almost every transform with a single test.
+    std::atomic<uint64_t> m_filter{ 0 };
+    // Starts at 1, an all zero index record never matches a real frame.
+    std::atomic<uint64_t> m_frame{ 1 };
+    std::atomic<bool> m_recording{ false };
+
+    using EnemyHandle = utility::re_managed_object::ManagedHandle<RopewayEnemyController>;
+
+    // Enemy controllers from the last update, so ones still in the list only get the handle's cheap check
+    // instead of the full one. Render thread only.
+    std::vector<EnemyHandle> m_enemies{};
+    std::vector<EnemyHandle> m_next_enemies{};
+
+    utility::MpscQueue<Sample> m_queue{ 4096 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+
+    // Only touched by the writer thread while it's running.
+    utility::MappedFile::Ptr m_file{};
+    std::thread m_writer{};
+    std::atomic<bool> m_running{ false };
+    std::array<SlotState, MAX_TRACKED> m_slots{};
+    std::vector<Sample> m_pending{};
+    std::vector<uint8_t> m_block{};
+    std::atomic<uint64_t> m_frames_written{ 0 };
+};
@@ -1,5 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <execution>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include <xmmintrin.h>
+
 #include "ReClass.hpp"
 
 namespace utility::re_array {
@@ -10,6 +18,8 @@ namespace utility::re_array {
     template<typename T> static T* get_ptr_element(::REArrayBase* container, int idx);
     template<typename T> static T* get_element(::REArrayBase* container, int idx);
 
+    template<typename T> class REArrayView;
+
     static bool has_inline_elements(::REArrayBase* container) {
         if (container->containedType == nullptr) {
             return false;
@@ -43,4 +53,161 @@ namespace utility::re_array {
     static T* get_element(::REArrayBase* container, int idx) {
         return has_inline_elements(container) ? get_inline_element<T>(container, idx) : get_ptr_element<T>(container, idx);
     }
+
+    // Resolves an array's layout once, so loops over it don't re-derive it for every element.
+    // Elements come out as T* either way: into the array itself for value types,
+    // or the referenced object for everything else.
+    template<typename T>
+    class REArrayView {
+    public:
+        // How far ahead iterating a pointer array prefetches the referenced objects.
+        static constexpr int32_t PREFETCH_DISTANCE{ 8 };
+
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T*;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T**;
+            using reference = T*;
+
+            Iterator(const REArrayView* view, int32_t index)
+                : m_view{ view },
+                m_index{ index }
+            {
+                m_view->prefetch(m_index + PREFETCH_DISTANCE);
+            }
+
+            T* operator*() const {
+                return m_view->get(m_index);
+            }
+
+            Iterator& operator++() {
+                ++m_index;
+                m_view->prefetch(m_index + PREFETCH_DISTANCE);
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const Iterator& other) const {
+                return m_index == other.m_index;
+            }
+
+            bool operator!=(const Iterator& other) const {
+                return m_index != other.m_index;
+            }
+
+            int32_t index() const {
+                return m_index;
+            }
+
+        private:
+            const REArrayView* m_view;
+            int32_t m_index;
+        };
+
+        REArrayView() = default;
+
+        explicit REArrayView(::REArrayBase* container) {
+            if (container == nullptr || container->numElements <= 0) {
+                return;
+            }
+
+            m_data = (uint8_t*)re_managed_object::get_field_ptr(container);
+            m_size = container->numElements;
+            m_inline = re_array::has_inline_elements(container);
+            m_stride = m_inline ? container->info->classInfo->elementSize : sizeof(void*);
+        }
+
+        int32_t size() const {
+            return m_size;
+        }
+
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        bool has_inline_elements() const {
+            return m_inline;
+        }
+
+        // The elements as a plain T array, for value type arrays whose element size matches T.
+        // nullptr otherwise.
+        T* data() const {
+            return m_inline && m_stride == sizeof(T) ? (T*)m_data : nullptr;
+        }
+
+        // No bounds check.
+        T* operator[](int32_t idx) const {
+            return get(idx);
+        }
+
+        T* at(int32_t idx) const {
+            return idx >= 0 && idx < m_size ? get(idx) : nullptr;
+        }
+
+        Iterator begin() const {
+            return { this, 0 };
+        }
+
+        Iterator end() const {
+            return { this, m_size };
+        }
+
+        // Splits the array into chunks of chunk_size and runs fn(T*, index) over them on the
+        // standard library's thread pool. fn must be safe to run concurrently with itself,
+        // which in practice means only reading the engine objects.
+        template<typename Fn>
+        void parallel_for(Fn fn, int32_t chunk_size = 256) const {
+            chunk_size = std::max<int32_t>(chunk_size, 1);
+
+            auto run_chunk = [&](int32_t chunk) {
+                auto first = chunk * chunk_size;
+                auto last = std::min(m_size, first + chunk_size);
+
+                for (auto i = first; i < last; ++i) {
+                    prefetch(i + PREFETCH_DISTANCE);
+                    fn(get(i), i);
+                }
+            };
+
+            auto num_chunks = (m_size + chunk_size - 1) / chunk_size;
+
+            if (num_chunks <= 1) {
+                run_chunk(0);
+                return;
+            }
+
+            std::vector<int32_t> chunks(num_chunks);
+            std::iota(chunks.begin(), chunks.end(), 0);
+            std::for_each(std::execution::par, chunks.begin(), chunks.end(), run_chunk);
+        }
+
+    private:
+        T* get(int32_t idx) const {
+            if (m_inline) {
+                return (T*)(m_data + (size_t)m_stride * idx);
+            }
+
+            return ((T**)m_data)[idx];
+        }
+
+        // Value type elements are contiguous and the hardware prefetcher already keeps up with them.
+        // The objects a pointer array references are scattered, so fetch them ahead of time.
+        void prefetch(int32_t idx) const {
+            if (!m_inline && idx < m_size) {
+                _mm_prefetch(((const char**)m_data)[idx], _MM_HINT_T0);
+            }
+        }
+
+        uint8_t* m_data{ nullptr };
+        int32_t m_size{ 0 };
+        uint32_t m_stride{ 0 };
+        bool m_inline{ false };
+    };
 }
\ No newline at end of file
@@ -46,8 +46,19 @@ namespace utility::re_component {
 
         arg.info = t->classInfo;
 
-        auto ret = utility::re_managed_object::call_method(comp->ownerGameObject, "getComponent", &arg);
+        auto game_object = comp->ownerGameObject;
 
-        return (T *)ret->params.out_data;
+        if (game_object == nullptr) {
+            return nullptr;
+        }
+
+        // Every game object shares getComponent, so it only needs resolving once.
+        static utility::re_managed_object::MethodHandle get_component{};
+
+        if (!get_component.is_valid()) {
+            get_component = utility::re_managed_object::get_method(game_object, "getComponent");
+        }
+
+        return (T *)utility::re_managed_object::invoke(get_component, game_object, &arg);
     }
 }
\ No newline at end of file
@@ -1,7 +1,5 @@
 #include <spdlog/spdlog.h>
 
-#include "utility/Scan.hpp"
-
 #include "REFramework.hpp"
 #include "REContext.hpp"
 
@@ -25,19 +23,17 @@ namespace sdk {
             return;
         }
 
-        // Version 1
-        //auto ref = utility::scan(g_framework->getModule().as<HMODULE>(), "48 8B 0D ? ? ? ? BA FF FF FF FF E8 ? ? ? ? 48 89 C3");
+        auto& signatures = g_framework->get_signatures();
+        auto global_context = signatures.get("GlobalContext");
+        auto get_thread_context = signatures.get("GetThreadContext");
 
-        // Version 2 Dec 17th, 2019, first ptr is at game.exe+0x7095E08
-        auto ref = utility::scan(g_framework->get_module().as<HMODULE>(), "48 8B 0D ? ? ? ? BA FF FF FF FF E8 ? ? ? ?");
-            
-        if (!ref) {
+        if (!global_context || !get_thread_context) {
             spdlog::info("[REGlobalContext::updatePointers] Unable to find ref.");
             return;
         }
 
-        s_global_context = (decltype(s_global_context))utility::calculate_absolute(*ref + 3);
-        s_get_thread_context = (decltype(s_get_thread_context))utility::calculate_absolute(*ref + 13);
+        s_global_context = (decltype(s_global_context))*global_context;
+        s_get_thread_context = (decltype(s_get_thread_context))*get_thread_context;
 
         spdlog::info("[REGlobalContext::updatePointers] s_globalContext: {:x}", (uintptr_t)s_global_context);
         spdlog::info("[REGlobalContext::updatePointers] s_getThreadContext: {:x}", (uintptr_t)s_get_thread_context);
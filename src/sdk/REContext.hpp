@@ -9,12 +9,14 @@ namespace sdk {
     public:
         static REGlobalContext* get();
 
+        // Finds the context's pointers if they haven't been found yet. get() does this on first use.
+        static void update_pointers();
+
     public:
         REThreadContext* get_thread_context(int32_t unk = -1);
 
     private:
         using ThreadContextFn = REThreadContext* (*)(REGlobalContext*, int32_t);
-        static void update_pointers();
 
         static REGlobalContext** s_global_context;
         static ThreadContextFn s_get_thread_context;
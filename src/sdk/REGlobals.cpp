@@ -1,7 +1,10 @@
+#include <cstring>
+
+#include <emmintrin.h>
+
 #include <spdlog/spdlog.h>
 
 #include "utility/Scan.hpp"
-#include "utility/Module.hpp"
 
 #include "REFramework.hpp"
 #include "REGlobals.hpp"
@@ -9,41 +12,88 @@
 REGlobals::REGlobals() {
     spdlog::info("REGlobals initialization");
 
-    auto mod = g_framework->get_module().as<HMODULE>();
-    auto start = (uintptr_t)mod;
-    auto end = (uintptr_t)start + *utility::get_module_size(mod);
+    auto& xrefs = g_framework->get_xrefs();
 
-    // generic pattern used for all these globals
-    auto pat = std::string{ "48 8D 0D ? ? ? ? 48 B8 00 00 00 00 00 00 00 80" };
+    if (xrefs == nullptr) {
+        spdlog::error("REGlobals: no xref index");
+        return;
+    }
 
-    // find all the globals
-    for (auto i = utility::scan(start, end - start, pat); i.has_value(); i = utility::scan(*i + 1, end - (*i + 1), pat)) {
-        auto ptr = utility::calculate_absolute(*i + 3);
+    // Every global is registered with the same sequence:
+    // lea rcx, [global]
+    // mov rax, 0x8000000000000000
+    static constexpr uint8_t MOV_RAX[]{ 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80 };
+    static constexpr auto PATTERN{ "48 8D 0D ? ? ? ? 48 B8 00 00 00 00 00 00 00 80" };
+    static constexpr size_t LEA_SIZE{ 7 };
 
+    auto add_global = [&](uintptr_t ptr) {
         // Make sure the pointer is aligned on an 8-byte boundary.
-        if (ptr == 0 || ((uintptr_t)ptr & (sizeof(void*) - 1)) != 0) {
-            continue;
-        }
-
-        if (IsBadReadPtr((void*)ptr, sizeof(void*))) {
-            continue;
+        if ((ptr & (sizeof(void*) - 1)) != 0) {
+            return false;
         }
 
         auto obj_ptr = (REManagedObject**)ptr;
 
         if (m_objects.find(obj_ptr) != m_objects.end()) {
-            continue;
+            return false;
         }
-        
+
         m_objects.insert(obj_ptr);
         m_object_list.push_back(obj_ptr);
+
+        return true;
+    };
+
+    // The index is sorted by target, so each global's references are consecutive.
+    uint32_t last_target = 0;
+
+    for (auto& xref : xrefs->get_xrefs()) {
+        if (xref.kind != utility::XrefIndex::Kind::LEA || xref.target == last_target) {
+            continue;
+        }
+
+        auto site = (const uint8_t*)xrefs->to_address(xref.site);
+
+        if (!xrefs->is_code((uintptr_t)site, LEA_SIZE + sizeof(MOV_RAX))) {
+            continue;
+        }
+
+        if (site[0] != 0x48 || site[1] != 0x8D || site[2] != 0x0D || memcmp(site + LEA_SIZE, MOV_RAX, sizeof(MOV_RAX)) != 0) {
+            continue;
+        }
+
+        last_target = xref.target;
+        add_global(xrefs->to_address(xref.target));
+    }
+
+    // The index is a linear sweep, which can lose a registration to data in the code right before it.
+    // A scan for the sequence picks up whatever it missed.
+    size_t missed = 0;
+
+    for (auto& section : xrefs->get_code_sections()) {
+        auto start = xrefs->to_address(section.rva);
+        auto end = start + section.size;
+
+        for (auto i = utility::scan(start, end - start, PATTERN); i.has_value(); i = utility::scan(*i + 1, end - (*i + 1), PATTERN)) {
+            if (add_global(utility::calculate_absolute(*i + 3))) {
+                ++missed;
+            }
+        }
     }
 
+    if (missed > 0) {
+        spdlog::info("REGlobals: {} globals were missing from the xref index", missed);
+    }
+
+    m_snapshot.resize(m_object_list.size(), nullptr);
+    m_current.resize(m_object_list.size(), nullptr);
+    m_slot_names.resize(m_object_list.size(), nullptr);
+
     spdlog::info("Finished REGlobals initialization");
 }
 
 REManagedObject* REGlobals::get(std::string_view name) {
-    std::lock_guard _{ m_map_mutex };
+    std::unique_lock lock{ m_map_mutex };
 
     auto get_obj = [&]() -> REManagedObject* {
         if (auto it = m_object_map.find(name.data()); it != m_object_map.end()) {
@@ -59,10 +109,31 @@ REManagedObject* REGlobals::get(std::string_view name) {
     // assume the user knows this object exists.
     if (obj == nullptr) {
         refresh_map();
+        obj = get_obj();
+
+        lock.unlock();
+        dispatch_changes();
+    }
+
+    return obj;
+}
+
+REManagedObject** REGlobals::get_slot(std::string_view name) {
+    std::unique_lock lock{ m_map_mutex };
+
+    if (auto it = m_object_map.find(name.data()); it != m_object_map.end()) {
+        return it->second;
     }
 
-    // try again after refreshing the map
-    return obj == nullptr ? get_obj() : obj;
+    refresh_map();
+
+    auto it = m_object_map.find(name.data());
+    auto slot = it != m_object_map.end() ? it->second : nullptr;
+
+    lock.unlock();
+    dispatch_changes();
+
+    return slot;
 }
 
 REManagedObject* REGlobals::operator[](std::string_view name) {
@@ -70,36 +141,172 @@ REManagedObject* REGlobals::operator[](std::string_view name) {
 }
 
 void REGlobals::safe_refresh() {
-    std::lock_guard _{ m_map_mutex };
-    refresh_map();
+    {
+        std::lock_guard _{ m_map_mutex };
+        refresh_map();
+    }
+
+    dispatch_changes();
+}
+
+void REGlobals::on_change(OnChangeFn fn) {
+    std::lock_guard _{ m_change_mutex };
+    m_on_change.emplace_back(std::move(fn));
 }
 
 void REGlobals::refresh_map() {
-    for (auto obj_ptr : m_objects) {
-        auto obj = *obj_ptr;
+    const auto count = m_object_list.size();
 
-        // Make sure the pointer is aligned on an 8-byte boundary.
-        if (obj == nullptr || ((uintptr_t)obj & (sizeof(void*) - 1)) != 0) {
+    // Gather every slot into one contiguous buffer so it can be diffed against the last pass in bulk.
+    for (size_t i = 0; i < count; ++i) {
+        m_current[i] = *m_object_list[i];
+    }
+
+    m_changed.clear();
+
+    size_t i = 0;
+
+    // Two pointers per compare. A pointer only matches if both of its dwords do.
+    for (; i + 2 <= count; i += 2) {
+        auto current = _mm_loadu_si128((const __m128i*)&m_current[i]);
+        auto previous = _mm_loadu_si128((const __m128i*)&m_snapshot[i]);
+        auto mask = _mm_movemask_epi8(_mm_cmpeq_epi32(current, previous));
+
+        if (mask == 0xFFFF) {
             continue;
         }
 
-        if (IsBadReadPtr(obj, sizeof(REManagedObject))) {
-            continue;
+        if ((mask & 0x00FF) != 0x00FF) {
+            m_changed.push_back(i);
         }
 
-        auto t = utility::re_managed_object::safe_get_type(obj);
+        if ((mask & 0xFF00) != 0xFF00) {
+            m_changed.push_back(i + 1);
+        }
+    }
 
-        if (t == nullptr || t->name == nullptr) {
-            continue;
+    for (; i < count; ++i) {
+        if (m_current[i] != m_snapshot[i]) {
+            m_changed.push_back(i);
+        }
+    }
+
+    // Objects that existed but weren't fully initialized last time get another chance,
+    // unless their slot changed, in which case they're handled below with the rest.
+    auto unresolved = std::move(m_unresolved);
+    m_unresolved.clear();
+
+    for (auto index : unresolved) {
+        if (m_current[index] == m_snapshot[index] && !resolve_slot(index)) {
+            m_unresolved.push_back(index);
+        }
+    }
+
+    for (auto index : m_changed) {
+        m_pending_changes.push_back({ m_object_list[index], m_snapshot[index], m_current[index] });
+        m_snapshot[index] = m_current[index];
+
+        if (!resolve_slot(index)) {
+            m_unresolved.push_back(index);
         }
+    }
+}
+
+bool REGlobals::resolve_slot(size_t index) {
+    auto obj_ptr = m_object_list[index];
+    auto obj = m_current[index];
 
-        if (m_acknowledged_objects.find(obj_ptr) == m_acknowledged_objects.end()) {
+    // Nothing to resolve, keep whatever mapping the slot had.
+    if (obj == nullptr) {
+        return true;
+    }
+
+    // Make sure the pointer is aligned on an 8-byte boundary.
+    if (((uintptr_t)obj & (sizeof(void*) - 1)) != 0) {
+        return false;
+    }
+
+    auto t = utility::re_managed_object::safe_get_type(obj);
+
+    if (t == nullptr || t->name == nullptr) {
+        return false;
+    }
+
+    if (m_acknowledged_objects.find(obj_ptr) == m_acknowledged_objects.end()) {
 #ifdef DEVELOPER
-            spdlog::info("{:x}->{:x} ({:s})", (uintptr_t)obj_ptr, (uintptr_t)*obj_ptr, t->name);
+        spdlog::info("{:x}->{:x} ({:s})", (uintptr_t)obj_ptr, (uintptr_t)obj, t->name);
 #endif
-            m_acknowledged_objects.insert(obj_ptr);
+        m_acknowledged_objects.insert(obj_ptr);
+    }
+
+    auto& slot_name = m_slot_names[index];
+
+    if (slot_name != nullptr && std::string_view{ slot_name } == t->name) {
+        return true;
+    }
+
+    // The slot now holds a different type, don't leave the old name pointing at it.
+    if (slot_name != nullptr) {
+        if (auto it = m_object_map.find(slot_name); it != m_object_map.end() && it->second == obj_ptr) {
+            m_object_map.erase(it);
+        }
+    }
+
+    slot_name = t->name;
+    m_object_map[t->name] = obj_ptr;
+
+    return true;
+}
+
+void REGlobals::dispatch_changes() {
+    std::vector<Change> changes{};
+
+    {
+        std::lock_guard _{ m_map_mutex };
+        changes.swap(m_pending_changes);
+    }
+
+    if (changes.empty()) {
+        return;
+    }
+
+    // Call the subscribers without holding the lock, one of them might subscribe something else.
+    std::vector<OnChangeFn> subscribers{};
+
+    {
+        std::lock_guard _{ m_change_mutex };
+        subscribers = m_on_change;
+    }
+
+    for (const auto& change : changes) {
+        for (auto& fn : subscribers) {
+            fn(change.slot, change.old_obj, change.new_obj);
         }
+    }
+}
+
+REManagedObject** GlobalHandleBase::bind() const {
+    auto& globals = g_framework->get_globals();
 
-        m_object_map[t->name] = obj_ptr;
+    if (globals == nullptr) {
+        return nullptr;
     }
+
+    auto slot = globals->get_slot(m_name);
+
+    if (slot != nullptr) {
+        m_slot.store(slot, std::memory_order_release);
+    }
+
+    return slot;
+}
+
+REManagedObject* GlobalHandleBase::validate(REManagedObject* obj) const {
+    if (!utility::re_managed_object::is_managed_object(obj)) {
+        return nullptr;
+    }
+
+    m_info.store(obj->info, std::memory_order_relaxed);
+
+    return obj;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -9,6 +11,9 @@
 // A list of globals in the RE engine (singletons?)
 class REGlobals {
 public:
+    // Called with the slot that changed, the object it used to hold and the object it holds now.
+    using OnChangeFn = std::function<void(REManagedObject**, REManagedObject*, REManagedObject*)>;
+
     REGlobals();
     virtual ~REGlobals() {};
 
@@ -29,11 +34,26 @@ public:
         return (T*)get(name);
     }
 
+    // The slot the named global lives in, refreshing the map if it hasn't been seen yet.
+    REManagedObject** get_slot(std::string_view name);
+
     // Lock a mutex and then refresh the map.
     void safe_refresh();
 
+    // Subscribers are notified after a refresh, outside of the map lock,
+    // so they are free to call back into REGlobals.
+    void on_change(OnChangeFn fn);
+
 private:
+    struct Change {
+        REManagedObject** slot;
+        REManagedObject* old_obj;
+        REManagedObject* new_obj;
+    };
+
     void refresh_map();
+    bool resolve_slot(size_t index);
+    void dispatch_changes();
 
     // Class name to object like "app.foo.bar" -> 0xDEADBEEF
     std::unordered_map<std::string, REManagedObject**> m_object_map;
@@ -44,5 +64,90 @@ private:
     // List of objects we've already logged
     std::unordered_set<REManagedObject**> m_acknowledged_objects;
 
+    // Slot values as of the last refresh, parallel to m_object_list.
+    std::vector<REManagedObject*> m_snapshot;
+    std::vector<REManagedObject*> m_current;
+    // Type name each slot was last mapped under, so a slot that changes type gets unmapped.
+    std::vector<const char*> m_slot_names;
+    std::vector<size_t> m_changed;
+    // Slots holding an object whose type couldn't be resolved yet, retried on every refresh.
+    std::vector<size_t> m_unresolved;
+
+    std::vector<Change> m_pending_changes;
+    std::vector<OnChangeFn> m_on_change;
+
     std::mutex m_map_mutex{};
+    std::mutex m_change_mutex{};
+};
+
+// Binds to a global's slot the first time it's used. The slot itself never moves,
+// so after that reading the instance is one load plus a check that it's still the same type.
+class GlobalHandleBase {
+public:
+    GlobalHandleBase(const GlobalHandleBase& other) = delete;
+    GlobalHandleBase& operator=(const GlobalHandleBase& other) = delete;
+
+    auto get_name() const {
+        return m_name;
+    }
+
+protected:
+    constexpr GlobalHandleBase(const char* name)
+        : m_name{ name }
+    {}
+
+    REManagedObject* get_object() const {
+        auto slot = m_slot.load(std::memory_order_acquire);
+
+        if (slot == nullptr && (slot = bind()) == nullptr) {
+            return nullptr;
+        }
+
+        // The game can replace the instance whenever it wants, so always read through the slot.
+        auto obj = *(REManagedObject* const volatile*)slot;
+
+        if (obj == nullptr) {
+            return nullptr;
+        }
+
+        auto info = m_info.load(std::memory_order_relaxed);
+
+        if (info == nullptr) {
+            return validate(obj);
+        }
+
+        return obj->info == info ? obj : nullptr;
+    }
+
+private:
+    REManagedObject** bind() const;
+    REManagedObject* validate(REManagedObject* obj) const;
+
+    std::string_view m_name;
+
+    mutable std::atomic<REManagedObject**> m_slot{ nullptr };
+    mutable std::atomic<REObjectInfo*> m_info{ nullptr };
+};
+
+// Name is a constant with linkage holding the global's type name, like
+//     static constexpr char ENEMY_MANAGER[]{ GAME_NAMESPACE "EnemyManager" };
+//     static GlobalHandle<RopewayEnemyManager, ENEMY_MANAGER> g_enemy_manager{};
+template <typename T, const char* Name>
+class GlobalHandle : public GlobalHandleBase {
+public:
+    constexpr GlobalHandle()
+        : GlobalHandleBase{ Name }
+    {}
+
+    T* get() const {
+        return (T*)get_object();
+    }
+
+    T* operator->() const {
+        return get();
+    }
+
+    explicit operator bool() const {
+        return get() != nullptr;
+    }
 };
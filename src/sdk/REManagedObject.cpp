@@ -0,0 +1,55 @@
+#include <windows.h>
+
+#include "ReClass.hpp"
+
+namespace utility::re_managed_object {
+    // Only access violations are handled, anything else (a guard page included) is the game's business.
+    static int filter_exception(DWORD code) {
+        return code == EXCEPTION_ACCESS_VIOLATION ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    // Kept out of the __try functions, which can't have anything that needs unwinding.
+    static bool check_managed_object(::REManagedObject* object) {
+        auto info = object->info;
+
+        if (info == nullptr || ((uintptr_t)info & (sizeof(void*) - 1)) != 0) {
+            return false;
+        }
+
+        auto class_info = info->classInfo;
+
+        if (class_info == nullptr || class_info->parentInfo != info) {
+            return false;
+        }
+
+        auto t = class_info->type;
+
+        if (t == nullptr || t->name == nullptr) {
+            return false;
+        }
+
+        // Touch the name, so a type in freed memory faults here instead of in the caller.
+        volatile auto c = *t->name;
+        (void)c;
+
+        return true;
+    }
+
+    bool probe_managed_object(::REManagedObject* object) {
+        __try {
+            return check_managed_object(object);
+        }
+        __except (filter_exception(GetExceptionCode())) {
+            return false;
+        }
+    }
+
+    bool probe_same_object(::REManagedObject* object, REObjectInfo* info, REType* type) {
+        __try {
+            return is_same_object(object, info, type);
+        }
+        __except (filter_exception(GetExceptionCode())) {
+            return false;
+        }
+    }
+}
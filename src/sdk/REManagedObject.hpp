@@ -1,11 +1,14 @@
 #pragma once
 
 #include <windows.h>
+#include <algorithm>
 #include <mutex>
 #include <memory>
+#include <shared_mutex>
 #include <string_view>
 
 #include "utility/Address.hpp"
+#include "utility/String.hpp"
 
 #include "ReClass.hpp"
 
@@ -14,6 +17,11 @@ namespace utility::re_managed_object {
     struct ParamWrapper;
     static bool is_managed_object(Address address);
 
+    // The checks behind is_managed_object, with the reads guarded by SEH instead of IsBadReadPtr.
+    bool probe_managed_object(::REManagedObject* object);
+    // Same check as ManagedHandle::get, guarded the same way.
+    bool probe_same_object(::REManagedObject* object, REObjectInfo* info, REType* type);
+
     // Check object type name
     static bool is_a(::REManagedObject* object, std::string_view name);
     // Check object type
@@ -46,9 +54,34 @@ namespace utility::re_managed_object {
     template <typename T>
     T get_field(::REManagedObject* obj, std::string_view field);
     
+    // Get a method descriptor by name
+    static FunctionDescriptor* get_method_desc(::REManagedObject* obj, std::string_view name);
+
+    // Allocates the parameter block, use a MethodHandle with invoke for anything called often.
     template <typename Arg>
     static std::unique_ptr<ParamWrapper> call_method(::REManagedObject* obj, std::string_view name, const Arg& arg);
 
+    // A method looked up once, for calling it every frame without resolving it again.
+    struct MethodHandle {
+        FunctionDescriptor* desc{ nullptr };
+
+        bool is_valid() const {
+            return desc != nullptr && desc->functionPtr != nullptr;
+        }
+    };
+
+    static MethodHandle get_method(::REManagedObject* obj, std::string_view name);
+
+    // Call a resolved method with the parameter block on the caller's stack.
+    // Returns whatever the method left in out_data.
+    template <typename Arg>
+    void* invoke(const MethodHandle& method, ::REManagedObject* obj, const Arg& arg);
+
+    // Call a resolved method on each object back to back with the same argument, reusing one
+    // parameter block and thread context. out[i] gets object i's out_data, nullptr for null objects.
+    template <typename Arg>
+    void invoke_batch(const MethodHandle& method, ::REManagedObject* const* objects, size_t count, const Arg& arg, void** out);
+
     struct ParamWrapper {
         ParamWrapper(::REManagedObject* obj) {
             params.object_ptr = (void*)obj;
@@ -64,36 +97,81 @@ namespace utility::re_managed_object {
             return false;
         }
 
-        if (IsBadReadPtr(address.ptr(), sizeof(void*))) {
+        return probe_managed_object(address.as<::REManagedObject*>());
+    }
+
+    // Whether object still has this info and type and hasn't been released. Only reads the object's header
+    // and its info, so it's cheap, but it trusts object to point at mapped memory.
+    static bool is_same_object(::REManagedObject* object, REObjectInfo* info, REType* type) {
+        if (object == nullptr || object->info != info || object->referenceCount == 0) {
             return false;
         }
 
-        auto object = address.as<::REManagedObject*>();
+        auto class_info = info->classInfo;
 
-        if (object->info == nullptr || IsBadReadPtr(object->info, sizeof(void*))) {
-            return false;
+        return class_info != nullptr && class_info->type == type;
+    }
+
+    // Holds on to an object across frames. The object is fully checked once when the handle is made,
+    // after that get() only confirms it still has the same info and type and hasn't been released.
+    // REObjectInfo is per type, and the object header has no generation or id to compare, so a new
+    // object of the same type allocated where the old one was can't be told apart from it.
+    template <typename T = ::REManagedObject>
+    class ManagedHandle {
+    public:
+        ManagedHandle() = default;
+
+        ManagedHandle(T* object) {
+            reset(object);
         }
 
-        auto class_info = object->info->classInfo;
+        void reset(T* object = nullptr) {
+            m_object = nullptr;
+            m_info = nullptr;
+            m_type = nullptr;
 
-        if (class_info == nullptr || IsBadReadPtr(class_info, sizeof(void*))) {
-            return false;
+            if (!is_managed_object(object)) {
+                return;
+            }
+
+            m_object = object;
+            m_info = m_object->info;
+            m_type = m_info->classInfo->type;
         }
 
-        if (class_info->parentInfo != object->info || class_info->type == nullptr) {
-            return false;
+        // nullptr once the object is released or an object of another type lives where it was.
+        // Fine for objects in the engine's own heaps, which stay mapped after they're freed.
+        T* get() const {
+            return is_same_object(m_object, m_info, m_type) ? m_object : nullptr;
         }
 
-        if (IsBadReadPtr(class_info->type, sizeof(REType)) || class_info->type->name == nullptr) {
-            return false;
+        // Same as get, but a pointer into memory that has been unmapped returns nullptr instead of faulting.
+        T* get_checked() const {
+            return m_object != nullptr && probe_same_object(m_object, m_info, m_type) ? m_object : nullptr;
         }
 
-        if (IsBadReadPtr(class_info->type->name, sizeof(void*))) {
-            return false;
+        T* operator->() const {
+            return get();
         }
 
-        return true;
-    }
+        explicit operator bool() const {
+            return get() != nullptr;
+        }
+
+        REType* get_type() const {
+            return m_type;
+        }
+
+        // The object the handle was made for, without checking it's still there. Only for comparing.
+        const T* get_address() const {
+            return m_object;
+        }
+
+    private:
+        T* m_object{ nullptr };
+        REObjectInfo* m_info{ nullptr };
+        REType* m_type{ nullptr };
+    };
 
     static REType* get_type(::REManagedObject* object) {
         if (object == nullptr) {
@@ -281,8 +359,9 @@ namespace utility::re_managed_object {
     }
 
     static FunctionDescriptor* get_method_desc(::REManagedObject* obj, std::string_view name) {
-        static std::mutex insertion_mutex{};
-        static std::unordered_map<std::string, FunctionDescriptor*> var_map{};
+        static std::shared_mutex cache_mutex{};
+        // Keyed by the object's type mixed with the name's hash, so a hit never builds a string.
+        static std::unordered_map<size_t, FunctionDescriptor*> desc_map{};
 
         auto t = get_type(obj);
 
@@ -290,7 +369,16 @@ namespace utility::re_managed_object {
             return nullptr;
         }
 
-        auto full_name = std::string{ t->name } + "." + name.data();
+        const auto key = utility::hash(name) ^ ((size_t)t * 0x9E3779B97F4A7C15);
+
+        {
+            std::shared_lock _{ cache_mutex };
+
+            // The name check guards against two keys mixing to the same value.
+            if (auto it = desc_map.find(key); it != desc_map.end() && name == it->second->name) {
+                return it->second;
+            }
+        }
 
         for (; t != nullptr; t = t->super) {
             auto fields = t->fields;
@@ -315,8 +403,8 @@ namespace utility::re_managed_object {
                 }
 
                 if (name == holder.descriptor->name) {
-                    std::lock_guard _{ insertion_mutex };
-                    var_map[full_name] = holder.descriptor;
+                    std::unique_lock _{ cache_mutex };
+                    desc_map[key] = holder.descriptor;
                     return holder.descriptor;
                 }
             }
@@ -325,6 +413,10 @@ namespace utility::re_managed_object {
         return nullptr;
     }
 
+    static MethodHandle get_method(::REManagedObject* obj, std::string_view name) {
+        return { get_method_desc(obj, name) };
+    }
+
     template <typename T>
     T get_field(::REManagedObject* obj, std::string_view field) {
         T data{};
@@ -362,4 +454,50 @@ namespace utility::re_managed_object {
 
         return nullptr;
     }
+
+    template <typename Arg>
+    void* invoke(const MethodHandle& method, ::REManagedObject* obj, const Arg& arg) {
+        if (!method.is_valid() || obj == nullptr) {
+            return nullptr;
+        }
+
+        auto method_func = (void* (*)(MethodParams*, ::REThreadContext*))method.desc->functionPtr;
+
+        MethodParams params{};
+        params.object_ptr = (void*)obj;
+        params.in_data = (void***)&arg;
+
+        method_func(&params, sdk::get_thread_context());
+
+        return params.out_data;
+    }
+
+    template <typename Arg>
+    void invoke_batch(const MethodHandle& method, ::REManagedObject* const* objects, size_t count, const Arg& arg, void** out) {
+        if (!method.is_valid()) {
+            std::fill(out, out + count, nullptr);
+            return;
+        }
+
+        auto method_func = (void* (*)(MethodParams*, ::REThreadContext*))method.desc->functionPtr;
+        auto context = sdk::get_thread_context();
+
+        MethodParams params{};
+
+        for (size_t i = 0; i < count; ++i) {
+            if (objects[i] == nullptr) {
+                out[i] = nullptr;
+                continue;
+            }
+
+            // Methods are free to scribble over the block, start each call from a clean one.
+            params = {};
+            params.object_ptr = (void*)objects[i];
+            params.in_data = (void***)&arg;
+
+            method_func(&params, context);
+
+            out[i] = params.out_data;
+        }
+    }
 }
\ No newline at end of file
@@ -1,53 +1,262 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+
+#include <emmintrin.h>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
-#include "ReClass.hpp"
+#include "Math.hpp"
 
 namespace utility::math {
     using namespace glm;
 
     static vec3 euler_angles(const glm::mat4& rot);
     static float fix_angle(float ang);
-    static void fix_angles(const glm::vec3& angles);
+    static void fix_angles(glm::vec3& angles);
     static float clamp_pitch(float ang);
 
+    //
+    // SSE helpers. Vector4f and the columns of Matrix4x4f are 4 packed floats, so they can be
+    // loaded as is. Unaligned loads are used because nothing guarantees the game's copies are aligned.
+    //
+    static __m128 load(const Vector4f& v) {
+        return _mm_loadu_ps(&v.x);
+    }
+
+    static void store(Vector4f& out, __m128 v) {
+        _mm_storeu_ps(&out.x, v);
+    }
+
+    // m * v, with m's columns already loaded.
+    static __m128 transform(__m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v) {
+        auto r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        return _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+    }
+
+    static Vector4f transform(const Matrix4x4f& m, const Vector4f& v) {
+        Vector4f out{};
+        store(out, transform(load(m[0]), load(m[1]), load(m[2]), load(m[3]), load(v)));
+        return out;
+    }
+
+    // out = a * b. out may alias either input.
+    static void multiply(const Matrix4x4f& a, const Matrix4x4f& b, Matrix4x4f& out) {
+        const auto c0 = load(a[0]);
+        const auto c1 = load(a[1]);
+        const auto c2 = load(a[2]);
+        const auto c3 = load(a[3]);
+
+        const auto r0 = transform(c0, c1, c2, c3, load(b[0]));
+        const auto r1 = transform(c0, c1, c2, c3, load(b[1]));
+        const auto r2 = transform(c0, c1, c2, c3, load(b[2]));
+        const auto r3 = transform(c0, c1, c2, c3, load(b[3]));
+
+        store(out[0], r0);
+        store(out[1], r1);
+        store(out[2], r2);
+        store(out[3], r3);
+    }
+
+    static __m128 floor_ps(__m128 v) {
+        // SSE2 has no floor, truncate and step down where that rounded up. Fine for anything that fits an int32.
+        auto t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.0f)));
+    }
+
+    // Wraps 4 angles into [-pi, pi]. Angles already in range, pi and -pi included, are returned as is.
+    static __m128 fix_angles(__m128 ang) {
+        const auto pi = _mm_set1_ps(glm::pi<float>());
+        const auto two_pi = _mm_set1_ps(glm::two_pi<float>());
+        const auto inv_two_pi = _mm_set1_ps(1.0f / glm::two_pi<float>());
+
+        auto turns = floor_ps(_mm_mul_ps(_mm_add_ps(ang, pi), inv_two_pi));
+        auto wrapped = _mm_sub_ps(ang, _mm_mul_ps(turns, two_pi));
+
+        const auto in_range = _mm_cmple_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), ang), pi);
+        return _mm_or_ps(_mm_and_ps(in_range, ang), _mm_andnot_ps(in_range, wrapped));
+    }
+
+    // At most about 2e-6 radians off std::atan2, signed zeros included, so atan2(+-0, -0) is +-pi
+    // and atan2(+-0, +0) is +-0. Infinities and NaNs aren't handled.
+    static __m128 atan2_ps(__m128 y, __m128 x) {
+        const auto sign_mask = _mm_set1_ps(-0.0f);
+        const auto abs_y = _mm_andnot_ps(sign_mask, y);
+        const auto abs_x = _mm_andnot_ps(sign_mask, x);
+
+        // Work on the ratio that's <= 1 and fix the octant up afterwards.
+        // When both are 0 the ratio is 0/0, that lane is zeroed instead.
+        const auto swap = _mm_cmpgt_ps(abs_y, abs_x);
+        const auto num = _mm_min_ps(abs_x, abs_y);
+        const auto den = _mm_max_ps(abs_x, abs_y);
+        const auto a = _mm_andnot_ps(_mm_cmpeq_ps(den, _mm_setzero_ps()), _mm_div_ps(num, den));
+        const auto a2 = _mm_mul_ps(a, a);
+
+        auto r = _mm_set1_ps(-0.01172120f);
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(0.05265332f));
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(-0.11643287f));
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(0.19354346f));
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(-0.33262347f));
+        r = _mm_add_ps(_mm_mul_ps(r, a2), _mm_set1_ps(0.99997726f));
+        r = _mm_mul_ps(r, a);
+
+        const auto half_pi = _mm_set1_ps(glm::half_pi<float>());
+        const auto pi = _mm_set1_ps(glm::pi<float>());
+
+        r = _mm_or_ps(_mm_and_ps(swap, _mm_sub_ps(half_pi, r)), _mm_andnot_ps(swap, r));
+
+        // By the sign bit rather than x < 0, so -0 counts as negative.
+        const auto x_negative = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+        r = _mm_or_ps(_mm_and_ps(x_negative, _mm_sub_ps(pi, r)), _mm_andnot_ps(x_negative, r));
+
+        // Take y's sign.
+        return _mm_or_ps(r, _mm_and_ps(y, sign_mask));
+    }
+
+    // Euler angles of 4 rotations at once, given the 3x3 part of each as m<column><row>.
+    // Same decomposition as glm::extractEulerAngleYZX, written out so the sin/cos of the first
+    // angle come straight from the values it was computed from.
+    static void euler_angles(__m128 m00, __m128 m01, __m128 m02, __m128 m10, __m128 m11, __m128 m12, __m128 m20, __m128 m21, __m128 m22,
+                             __m128& pitch, __m128& yaw, __m128& roll) {
+        const auto neg_m02 = _mm_xor_ps(m02, _mm_set1_ps(-0.0f));
+
+        yaw = atan2_ps(neg_m02, m00);
+
+        const auto c2 = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(m11, m11), _mm_mul_ps(m21, m21)));
+        roll = atan2_ps(m01, c2);
+
+        // sin/cos of atan2(y, x) are y/|v| and x/|v|. When both are zero the angle is 0 or pi
+        // depending on the sign of x, so sin is 0 and cos takes x's sign.
+        const auto len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(neg_m02, neg_m02), _mm_mul_ps(m00, m00)));
+        const auto degenerate = _mm_cmpeq_ps(len, _mm_setzero_ps());
+        const auto inv_len = _mm_div_ps(_mm_set1_ps(1.0f), len);
+        const auto s1 = _mm_andnot_ps(degenerate, _mm_mul_ps(neg_m02, inv_len));
+        const auto one_with_sign = _mm_or_ps(_mm_set1_ps(1.0f), _mm_and_ps(m00, _mm_set1_ps(-0.0f)));
+        const auto c1 = _mm_or_ps(_mm_and_ps(degenerate, one_with_sign), _mm_andnot_ps(degenerate, _mm_mul_ps(m00, inv_len)));
+
+        pitch = atan2_ps(_mm_add_ps(_mm_mul_ps(s1, m10), _mm_mul_ps(c1, m12)), _mm_add_ps(_mm_mul_ps(s1, m20), _mm_mul_ps(c1, m22)));
+    }
+
     // RE engine's way of storing euler angles or I'm just an idiot.
     static vec3 euler_angles(const glm::mat4& rot) {
-        float pitch = 0.0f;
-        float yaw = 0.0f;
-        float roll = 0.0f;
-        glm::extractEulerAngleYZX(rot, yaw, roll, pitch);
+        // Same as glm::extractEulerAngleYZX(rot, yaw, roll, pitch), minus the sin/cos.
+        const auto yaw = std::atan2(-rot[0][2], rot[0][0]);
+        const auto roll = std::atan2(rot[0][1], std::sqrt(rot[1][1] * rot[1][1] + rot[2][1] * rot[2][1]));
+
+        const auto len = std::sqrt(rot[0][2] * rot[0][2] + rot[0][0] * rot[0][0]);
+        const auto s1 = len > 0.0f ? -rot[0][2] / len : 0.0f;
+        const auto c1 = len > 0.0f ? rot[0][0] / len : std::copysign(1.0f, rot[0][0]);
+        const auto pitch = std::atan2(s1 * rot[1][0] + c1 * rot[1][2], s1 * rot[2][0] + c1 * rot[2][2]);
 
         return { pitch, yaw, roll };
     }
 
-    static float fix_angle(float ang) {
-        auto angDeg = glm::degrees(ang);
+    // Batched euler_angles, results are within the precision of atan2_ps of the scalar version.
+    static void euler_angles(const Matrix4x4f* matrices, Vector3f* out, size_t count) {
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            const auto& a = matrices[i + 0];
+            const auto& b = matrices[i + 1];
+            const auto& c = matrices[i + 2];
+            const auto& d = matrices[i + 3];
+
+            __m128 pitch{}, yaw{}, roll{};
+            euler_angles(_mm_setr_ps(a[0][0], b[0][0], c[0][0], d[0][0]), _mm_setr_ps(a[0][1], b[0][1], c[0][1], d[0][1]), _mm_setr_ps(a[0][2], b[0][2], c[0][2], d[0][2]),
+                         _mm_setr_ps(a[1][0], b[1][0], c[1][0], d[1][0]), _mm_setr_ps(a[1][1], b[1][1], c[1][1], d[1][1]), _mm_setr_ps(a[1][2], b[1][2], c[1][2], d[1][2]),
+                         _mm_setr_ps(a[2][0], b[2][0], c[2][0], d[2][0]), _mm_setr_ps(a[2][1], b[2][1], c[2][1], d[2][1]), _mm_setr_ps(a[2][2], b[2][2], c[2][2], d[2][2]),
+                         pitch, yaw, roll);
 
-        while (angDeg > 180.0f) {
-            angDeg -= 360.0f;
+            float p[4], y[4], r[4];
+            _mm_storeu_ps(p, pitch);
+            _mm_storeu_ps(y, yaw);
+            _mm_storeu_ps(r, roll);
+
+            for (size_t j = 0; j < 4; ++j) {
+                out[i + j] = { p[j], y[j], r[j] };
+            }
         }
 
-        while (angDeg < -180.0f) {
-            angDeg += 360.0f;
+        for (; i < count; ++i) {
+            out[i] = euler_angles(matrices[i]);
         }
+    }
+
+    // Same as euler_angles(mat4_cast(q)) for each quaternion, without building the matrices.
+    static void euler_angles(const glm::quat* rotations, Vector3f* out, size_t count) {
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            const auto& a = rotations[i + 0];
+            const auto& b = rotations[i + 1];
+            const auto& c = rotations[i + 2];
+            const auto& d = rotations[i + 3];
+
+            const auto x = _mm_setr_ps(a.x, b.x, c.x, d.x);
+            const auto y = _mm_setr_ps(a.y, b.y, c.y, d.y);
+            const auto z = _mm_setr_ps(a.z, b.z, c.z, d.z);
+            const auto w = _mm_setr_ps(a.w, b.w, c.w, d.w);
+
+            const auto one = _mm_set1_ps(1.0f);
+            const auto two = _mm_set1_ps(2.0f);
+            const auto xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            const auto xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            const auto wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+            // Same terms as glm::mat3_cast.
+            __m128 pitch{}, yaw{}, roll{};
+            euler_angles(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), _mm_mul_ps(two, _mm_add_ps(xy, wz)), _mm_mul_ps(two, _mm_sub_ps(xz, wy)),
+                         _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), _mm_mul_ps(two, _mm_add_ps(yz, wx)),
+                         _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))),
+                         pitch, yaw, roll);
 
-        return glm::radians(angDeg);
+            float p[4], ya[4], r[4];
+            _mm_storeu_ps(p, pitch);
+            _mm_storeu_ps(ya, yaw);
+            _mm_storeu_ps(r, roll);
+
+            for (size_t j = 0; j < 4; ++j) {
+                out[i + j] = { p[j], ya[j], r[j] };
+            }
+        }
+
+        for (; i < count; ++i) {
+            out[i] = euler_angles(glm::mat4_cast(rotations[i]));
+        }
+    }
+
+    // Wraps into [-pi, pi], leaving angles already in range alone.
+    static float fix_angle(float ang) {
+        const auto wrapped = ang - glm::two_pi<float>() * std::floor((ang + glm::pi<float>()) * (1.0f / glm::two_pi<float>()));
+        return std::abs(ang) <= glm::pi<float>() ? ang : wrapped;
     }
 
     static void fix_angles(glm::vec3& angles) {
-        angles[0] = fix_angle(angles[0]);
-        angles[1] = fix_angle(angles[1]);
-        angles[2] = fix_angle(angles[2]);
+        float v[4]{ angles[0], angles[1], angles[2], 0.0f };
+        _mm_storeu_ps(v, fix_angles(_mm_loadu_ps(v)));
+
+        angles = { v[0], v[1], v[2] };
+    }
+
+    static void fix_angles(float* angles, size_t count) {
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(angles + i, fix_angles(_mm_loadu_ps(angles + i)));
+        }
+
+        for (; i < count; ++i) {
+            angles[i] = fix_angle(angles[i]);
+        }
     }
 
-    float clamp_pitch(float ang) {
+    static float clamp_pitch(float ang) {
         return std::clamp(ang, glm::radians(-89.0f), glm::radians(89.0f));
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <xmmintrin.h>
+
+#include "utility/String.hpp"
+
+#include "ReClass_Layout.hpp"
+#include "REMath.hpp"
+#include "RETransform.hpp"
+
+namespace utility::re_transform {
+    namespace {
+        struct SkeletonIndex {
+            int32_t size{ 0 };
+            // Used to notice a different skeleton being allocated where an old one was.
+            const REJointDesc* first_desc{ nullptr };
+
+            // Hash of the joint name -> index into REJointArray::data
+            std::unordered_map<size_t, int32_t> by_name{};
+            // REJointDesc::nameHash -> index into REJointArray::data
+            std::unordered_map<uint32_t, int32_t> by_name_hash{};
+
+            // Keys that were still missing right after a rebuild, so looking them up again doesn't
+            // rebuild every time. Only forgotten when the skeleton changes, not by the rebuild a miss causes.
+            std::unordered_set<size_t> missing_names{};
+            std::unordered_set<uint32_t> missing_name_hashes{};
+        };
+
+        // Stop growing the cache past this many skeletons, just start over.
+        constexpr size_t MAX_SKELETONS{ 512 };
+
+        // Keyed by REJointArray::data. Transforms get updated from several threads,
+        // so each thread keeps its own cache instead of locking.
+        thread_local std::unordered_map<const void*, SkeletonIndex> g_skeletons{};
+
+        bool is_joint_array_valid(const ::REJointArray& joint_array) {
+            return joint_array.size > 0 && joint_array.numAllocated > 0 && joint_array.data != nullptr && joint_array.matrices != nullptr;
+        }
+
+        const REJointDesc* get_desc(const ::REJointArray& joint_array, int32_t index) {
+            auto joint = joint_array.data->joints[index];
+
+            if (joint == nullptr) {
+                return nullptr;
+            }
+
+            return joint->info;
+        }
+
+        void build_index(const ::REJointArray& joint_array, SkeletonIndex& index) {
+            index.size = joint_array.size;
+            index.first_desc = get_desc(joint_array, 0);
+            index.by_name.clear();
+            index.by_name_hash.clear();
+
+            for (int32_t i = 0; i < joint_array.size; ++i) {
+                auto joint_info = get_desc(joint_array, i);
+
+                if (joint_info == nullptr || joint_info->name == nullptr) {
+                    continue;
+                }
+
+                index.by_name.emplace(utility::hash(std::wstring_view{ joint_info->name }), i);
+                index.by_name_hash.emplace(joint_info->nameHash, i);
+            }
+        }
+
+        void forget_missing(SkeletonIndex& index) {
+            index.missing_names.clear();
+            index.missing_name_hashes.clear();
+        }
+
+        SkeletonIndex& get_index(const ::REJointArray& joint_array) {
+            if (g_skeletons.size() >= MAX_SKELETONS && g_skeletons.find(joint_array.data) == g_skeletons.end()) {
+                g_skeletons.clear();
+            }
+
+            auto& index = g_skeletons[joint_array.data];
+
+            if (index.size != joint_array.size || index.first_desc != get_desc(joint_array, 0)) {
+                forget_missing(index);
+                build_index(joint_array, index);
+            }
+
+            return index;
+        }
+
+        template <typename Map, typename Set, typename Key, typename Pred>
+        JointHandle resolve(const ::RETransform& transform, Map SkeletonIndex::*map, Set SkeletonIndex::*missing, const Key& key, Pred is_match) {
+            auto& joint_array = transform.joints;
+
+            if (!is_joint_array_valid(joint_array)) {
+                return {};
+            }
+
+            auto& index = get_index(joint_array);
+
+            // Second pass only happens when the cached entry turned out to be stale. The joints can be
+            // reallocated at the same address with the same size, so a miss can be stale too.
+            for (auto rebuild : { false, true }) {
+                if (rebuild) {
+                    build_index(joint_array, index);
+                }
+
+                auto it = (index.*map).find(key);
+
+                if (it == (index.*map).end()) {
+                    if (rebuild) {
+                        (index.*missing).insert(key);
+                    }
+
+                    if (rebuild || (index.*missing).count(key) != 0) {
+                        return {};
+                    }
+
+                    continue;
+                }
+
+                auto i = it->second;
+                auto joint_info = i < joint_array.size ? get_desc(joint_array, i) : nullptr;
+
+                if (joint_info != nullptr && is_match(*joint_info)) {
+                    return { joint_info, i };
+                }
+
+                // A stale entry means the skeleton changed without its size or first joint changing,
+                // so what was missing before may be there now.
+                forget_missing(index);
+            }
+
+            return {};
+        }
+    }
+
+    JointHandle resolve_joint(const ::RETransform& transform, std::wstring_view name) {
+        return resolve(transform, &SkeletonIndex::by_name, &SkeletonIndex::missing_names, utility::hash(name), [&](const REJointDesc& desc) {
+            return desc.name != nullptr && name == desc.name;
+        });
+    }
+
+    JointHandle resolve_joint(const ::RETransform& transform, uint32_t name_hash) {
+        return resolve(transform, &SkeletonIndex::by_name_hash, &SkeletonIndex::missing_name_hashes, name_hash, [&](const REJointDesc& desc) {
+            return desc.nameHash == name_hash;
+        });
+    }
+
+    bool is_joint_valid(const ::RETransform& transform, const JointHandle& handle) {
+        auto& joint_array = transform.joints;
+
+        if (!handle.is_valid() || !is_joint_array_valid(joint_array) || handle.index >= joint_array.size) {
+            return false;
+        }
+
+        return get_desc(joint_array, handle.index) == handle.desc;
+    }
+
+    size_t get_joint_matrices(const ::RETransform& transform, const JointHandle* handles, size_t count, Matrix4x4f* out) {
+        size_t num_valid = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            if (!is_joint_valid(transform, handles[i])) {
+                out[i] = invalid_matrix;
+                continue;
+            }
+
+            out[i] = transform.joints.matrices->data[handles[i].desc->jointNumber].worldMatrix;
+            ++num_valid;
+        }
+
+        return num_valid;
+    }
+
+    size_t get_joint_count(const ::RETransform& transform) {
+        auto& joint_array = transform.joints;
+
+        if (!is_joint_array_valid(joint_array)) {
+            return 0;
+        }
+
+        return std::min<size_t>(joint_array.size, std::size(joint_array.matrices->data));
+    }
+
+    size_t copy_joint_matrices(const ::RETransform& transform, Matrix4x4f* out, size_t capacity) {
+        auto count = std::min(get_joint_count(transform), capacity);
+
+        if (count == 0) {
+            return 0;
+        }
+
+        auto src = (const float*)&transform.joints.matrices->data[0].worldMatrix;
+        auto dst = (float*)out;
+
+        for (size_t i = 0; i < count * 16; i += 16) {
+            _mm_prefetch((const char*)(src + i + 64), _MM_HINT_T0);
+
+            _mm_storeu_ps(dst + i + 0, _mm_loadu_ps(src + i + 0));
+            _mm_storeu_ps(dst + i + 4, _mm_loadu_ps(src + i + 4));
+            _mm_storeu_ps(dst + i + 8, _mm_loadu_ps(src + i + 8));
+            _mm_storeu_ps(dst + i + 12, _mm_loadu_ps(src + i + 12));
+        }
+
+        return count;
+    }
+
+    size_t transform_joint_matrices(const ::RETransform& transform, const Matrix4x4f& m, Matrix4x4f* out, size_t capacity) {
+        auto count = std::min(get_joint_count(transform), capacity);
+
+        if (count == 0) {
+            return 0;
+        }
+
+        const auto m0 = utility::math::load(m[0]);
+        const auto m1 = utility::math::load(m[1]);
+        const auto m2 = utility::math::load(m[2]);
+        const auto m3 = utility::math::load(m[3]);
+
+        auto src = (const float*)&transform.joints.matrices->data[0].worldMatrix;
+        auto dst = (float*)out;
+
+        for (size_t i = 0; i < count * 16; i += 16) {
+            _mm_prefetch((const char*)(src + i + 64), _MM_HINT_T0);
+
+            // Column major, so each column of the result is m's columns weighted by the source column.
+            for (size_t col = 0; col < 16; col += 4) {
+                auto r = utility::math::transform(m0, m1, m2, m3, _mm_loadu_ps(src + i + col));
+
+                _mm_storeu_ps(dst + i + col, r);
+            }
+        }
+
+        return count;
+    }
+
+    void decompose_joint_matrices(const Matrix4x4f* matrices, size_t count, SkeletonPose& out) {
+        out.resize(count);
+
+        const auto one = _mm_set1_ps(1.0f);
+        const auto epsilon = _mm_set1_ps(1e-8f);
+
+        for (size_t i = 0; i < count; ++i) {
+            auto m = (const float*)&matrices[i];
+
+            auto c0 = _mm_loadu_ps(m + 0);
+            auto c1 = _mm_loadu_ps(m + 4);
+            auto c2 = _mm_loadu_ps(m + 8);
+
+            _mm_storeu_ps(&out.positions[i].x, _mm_loadu_ps(m + 12));
+
+            // Transposed, the squared lengths of all three basis vectors come out of one sum.
+            auto t0 = c0;
+            auto t1 = c1;
+            auto t2 = c2;
+            auto t3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+
+            auto scale = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(t0, t0), _mm_mul_ps(t1, t1)), _mm_mul_ps(t2, t2)));
+            auto inv_scale = _mm_div_ps(one, _mm_max_ps(scale, epsilon));
+
+            _mm_storeu_ps(&out.scales[i].x, scale);
+
+            Vector4f axes[3]{};
+            _mm_storeu_ps(&axes[0].x, _mm_mul_ps(c0, _mm_shuffle_ps(inv_scale, inv_scale, _MM_SHUFFLE(0, 0, 0, 0))));
+            _mm_storeu_ps(&axes[1].x, _mm_mul_ps(c1, _mm_shuffle_ps(inv_scale, inv_scale, _MM_SHUFFLE(1, 1, 1, 1))));
+            _mm_storeu_ps(&axes[2].x, _mm_mul_ps(c2, _mm_shuffle_ps(inv_scale, inv_scale, _MM_SHUFFLE(2, 2, 2, 2))));
+
+            out.rotations[i] = glm::quat_cast(Matrix3x3f{ Vector3f{ axes[0] }, Vector3f{ axes[1] }, Vector3f{ axes[2] } });
+        }
+    }
+
+    size_t get_skeleton_pose(const ::RETransform& transform, SkeletonPose& out) {
+        auto count = get_joint_count(transform);
+
+        if (count == 0) {
+            out.resize(0);
+            return 0;
+        }
+
+        decompose_joint_matrices(&transform.joints.matrices->data[0].worldMatrix, count, out);
+        return count;
+    }
+
+    void get_pose_delta(const SkeletonPose& prev, const SkeletonPose& cur, SkeletonPose& out) {
+        auto count = std::min(prev.size(), cur.size());
+
+        out.resize(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            _mm_storeu_ps(&out.positions[i].x, _mm_sub_ps(_mm_loadu_ps(&cur.positions[i].x), _mm_loadu_ps(&prev.positions[i].x)));
+            _mm_storeu_ps(&out.scales[i].x, _mm_sub_ps(_mm_loadu_ps(&cur.scales[i].x), _mm_loadu_ps(&prev.scales[i].x)));
+
+            out.rotations[i] = cur.rotations[i] * glm::conjugate(prev.rotations[i]);
+        }
+    }
+}
@@ -1,45 +1,89 @@
 #pragma once
 
+#include <vector>
+
 #include "Math.hpp"
 
 namespace utility::re_transform {
     static Matrix4x4f invalid_matrix{};
 
-    // Get a bone/joint by name
-    static REJoint* get_joint(const ::RETransform& transform, std::wstring_view name) {
-        auto& joint_array = transform.joints;
+    // A joint looked up by name once. Only valid for the skeleton it was resolved from,
+    // and checked against it again on every use.
+    struct JointHandle {
+        const REJointDesc* desc{ nullptr };
+        int32_t index{ -1 };
 
-        if (joint_array.size <= 0 || joint_array.numAllocated <= 0 || joint_array.data == nullptr || joint_array.matrices == nullptr) {
-            return nullptr;
+        bool is_valid() const {
+            return desc != nullptr;
         }
+    };
 
-        for (int32_t i = 0; i < joint_array.size; ++i) {
-            auto joint = joint_array.data->joints[i];
+    // Look a joint up through an index of the transform's skeleton, built the first time it's seen
+    // and rebuilt when the skeleton changes.
+    JointHandle resolve_joint(const ::RETransform& transform, std::wstring_view name);
+    // Same, but by the REJointDesc::nameHash the engine computed for the joint.
+    JointHandle resolve_joint(const ::RETransform& transform, uint32_t name_hash);
 
-            if (joint == nullptr) {
-                continue;
-            }
+    // Whether the handle still points at the same joint in this transform's skeleton.
+    bool is_joint_valid(const ::RETransform& transform, const JointHandle& handle);
 
-            auto joint_info = joint->info;
+    // Copies the world matrix of every handle into out, invalid_matrix for handles that no longer match.
+    // Returns how many handles were valid.
+    size_t get_joint_matrices(const ::RETransform& transform, const JointHandle* handles, size_t count, Matrix4x4f* out);
 
-            if (joint_info == nullptr || joint_info->name == nullptr) {
-                continue;
-            }
+    // Every joint of a skeleton split into separate arrays, indexed the same way as the joint matrices
+    // (REJointDesc::jointNumber). Owned by the caller so it can be reused from frame to frame.
+    struct SkeletonPose {
+        std::vector<Vector4f> positions{};
+        std::vector<glm::quat> rotations{};
+        std::vector<Vector4f> scales{};
+
+        void resize(size_t count) {
+            positions.resize(count);
+            rotations.resize(count);
+            scales.resize(count);
+        }
+
+        size_t size() const {
+            return positions.size();
+        }
+    };
 
-            if (name == joint_info->name) {
-                return joint;
-            }
+    // Number of joint matrices the transform has, 0 if the skeleton isn't set up.
+    size_t get_joint_count(const ::RETransform& transform);
+
+    // Copies every joint's world matrix into out, which needs room for get_joint_count() matrices.
+    // Returns how many were copied, never more than capacity.
+    size_t copy_joint_matrices(const ::RETransform& transform, Matrix4x4f* out, size_t capacity);
+    // Same, but each matrix is multiplied by m first (m * world), e.g. to move the skeleton into another space.
+    size_t transform_joint_matrices(const ::RETransform& transform, const Matrix4x4f& m, Matrix4x4f* out, size_t capacity);
+
+    // Splits matrices into position, rotation and scale. out is resized to count.
+    void decompose_joint_matrices(const Matrix4x4f* matrices, size_t count, SkeletonPose& out);
+    // Decomposes the transform's joint matrices straight from the game's memory, without an intermediate copy.
+    size_t get_skeleton_pose(const ::RETransform& transform, SkeletonPose& out);
+    // Per joint change from prev to cur. Positions and scales are differences,
+    // rotations are the rotation taking prev to cur (cur * inverse(prev)).
+    // Only the joints both poses have are compared, out is resized to match.
+    void get_pose_delta(const SkeletonPose& prev, const SkeletonPose& cur, SkeletonPose& out);
+
+    // Get a bone/joint by name
+    static REJoint* get_joint(const ::RETransform& transform, std::wstring_view name) {
+        auto handle = resolve_joint(transform, name);
+
+        if (!handle.is_valid()) {
+            return nullptr;
         }
 
-        return nullptr;
+        return transform.joints.data->joints[handle.index];
     }
 
     // Get a bone/joint matrix by name
     static Matrix4x4f& get_joint_matrix(const ::RETransform& transform, std::wstring_view name) {
-        auto joint = get_joint(transform, name);
+        auto handle = resolve_joint(transform, name);
 
-        if (joint != nullptr) {
-            return transform.joints.matrices->data[joint->info->jointNumber].worldMatrix;
+        if (handle.is_valid()) {
+            return transform.joints.matrices->data[handle.desc->jointNumber].worldMatrix;
         }
 
         return invalid_matrix;
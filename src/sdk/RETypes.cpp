@@ -1,28 +1,39 @@
 #include <spdlog/spdlog.h>
 
-#include "utility/Scan.hpp"
-
 #include "REFramework.hpp"
 #include "RETypes.hpp"
 
 std::string game_namespace(std::string_view base_name)
 {
-#ifdef RE3
-    return std::string{ "offline." } + base_name.data();
-#else
-    return std::string{ "app.ropeway." } + base_name.data();
-#endif
+    return std::string{ GAME_NAMESPACE } + base_name.data();
+}
+
+// Whether t looks like a type with a name. Unused entries in the list can point anywhere,
+// so the reads are guarded instead of asking IsBadReadPtr about every page first.
+static bool is_valid_type(REType* t) {
+    if (t == nullptr || ((uintptr_t)t & (sizeof(void*) - 1)) != 0) {
+        return false;
+    }
+
+    __try {
+        return t->name != nullptr && *t->name != '\0';
+    }
+    __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH) {
+        return false;
+    }
 }
 
 RETypes::RETypes() {
     spdlog::info("RETypes initialization");
 
-    auto mod = g_framework->get_module().as<HMODULE>();
-    auto ref = utility::scan(mod, "48 8d 0d ? ? ? ? e8 ? ? ? ? 48 8d 05 ? ? ? ? 48 89 03");
+    auto type_list = g_framework->get_signatures().get("TypeList");
+
+    if (!type_list) {
+        spdlog::error("Unable to find TypeList");
+        return;
+    }
 
-    spdlog::info("Ref: {:x}", (uintptr_t)*ref);
-    //
-    m_raw_types = (TypeList*)(utility::calculate_absolute(*ref + 3));
+    m_raw_types = (TypeList*)*type_list;
     spdlog::info("TypeList: {:x}", (uintptr_t)m_raw_types);
 
     auto& typeList = *m_raw_types;
@@ -31,7 +42,7 @@ RETypes::RETypes() {
     for (auto i = 0; i < typeList.numAllocated; ++i) {
         auto t = (*typeList.data)[i];
 
-        if (t == nullptr || IsBadReadPtr(t, sizeof(REType)) || ((uintptr_t)t & (sizeof(void*) - 1)) != 0) {
+        if (!is_valid_type(t)) {
             continue;
         }
         //
@@ -88,13 +99,17 @@ void RETypes::safe_refresh() {
 }
 
 void RETypes::refresh_map() {
+    if (m_raw_types == nullptr) {
+        return;
+    }
+
     auto& typeList = *m_raw_types;
 
     // I don't know why but it can extend past the size.
     for (auto i = 0; i < typeList.numAllocated; ++i) {
         auto t = (*typeList.data)[i];
 
-        if (t == nullptr || IsBadReadPtr(t, sizeof(REType)) || ((uintptr_t)t & (sizeof(void*) - 1)) != 0) {
+        if (!is_valid_type(t)) {
             continue;
         }
 
@@ -6,6 +6,13 @@
 
 #include "ReClass.hpp"
 
+// Prefix of the game's own types, usable in string literals like GAME_NAMESPACE "EnemyManager".
+#ifdef RE3
+#define GAME_NAMESPACE "offline."
+#else
+#define GAME_NAMESPACE "app.ropeway."
+#endif
+
 std::string game_namespace(std::string_view base_name);
 
 // A list of types in the RE engine
@@ -1,15 +1,6 @@
 #pragma once
 
-#include <cstdint>
-#include "Math.hpp"
-
-#pragma pack(push, r1, 1)
-#ifdef RE3
-#include "ReClass_Internal_RE3.hpp"
-#else
-#include "ReClass_Internal.hpp"
-#endif
-#pragma pack(pop, r1)
+#include "ReClass_Layout.hpp"
 
 #include "Enums_Internal.hpp"
 
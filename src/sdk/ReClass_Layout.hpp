@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include "Math.hpp"
+
+// Only the game's classes as ReClass.NET dumped them, without the helpers in ReClass.hpp that need Windows.
+#pragma pack(push, r1, 1)
+#ifdef RE3
+#include "ReClass_Internal_RE3.hpp"
+#else
+#include "ReClass_Internal.hpp"
+#endif
+#pragma pack(pop, r1)
@@ -0,0 +1,248 @@
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "String.hpp"
+#include "BinaryConfig.hpp"
+
+using namespace std;
+
+namespace utility {
+    namespace {
+        bool is_newer(const string& path, const string& than) {
+            error_code ec{};
+
+            auto write_time = filesystem::last_write_time(filesystem::u8path(path), ec);
+
+            if (ec) {
+                return false;
+            }
+
+            auto other_write_time = filesystem::last_write_time(filesystem::u8path(than), ec);
+
+            return !ec && write_time > other_write_time;
+        }
+    }
+
+    BinaryConfig::Ptr BinaryConfig::open(const string& path) {
+        auto cfg = Ptr{ new BinaryConfig{} };
+
+        cfg->m_file = MappedFile::open_read_only(path);
+
+        if (cfg->m_file == nullptr || cfg->m_file->get_size() < sizeof(Header)) {
+            return nullptr;
+        }
+
+        auto data = cfg->m_file->get_data();
+
+        cfg->m_header = (const Header*)data;
+        cfg->m_slots = (const Slot*)(data + sizeof(Header));
+        cfg->m_strings = (const char*)(data + cfg->m_header->strings_offset);
+
+        if (!cfg->validate()) {
+            spdlog::error("{} is not a valid binary config", path);
+            return nullptr;
+        }
+
+        return cfg;
+    }
+
+    bool BinaryConfig::save(const Config& cfg, const string& path) {
+        auto& key_values = cfg.get_key_values();
+
+        uint32_t num_slots = 8;
+
+        // Keep the table at most half full so probes stay short.
+        while (num_slots < key_values.size() * 2) {
+            num_slots <<= 1;
+        }
+
+        vector<Slot> slots(num_slots);
+        string strings{};
+
+        auto add_string = [&](string_view s) {
+            auto offset = (uint32_t)strings.size();
+            strings.append(s);
+            return offset;
+        };
+
+        for (auto& [key, value] : key_values) {
+            Slot slot{};
+            slot.hash = hash(key);
+            slot.key_offset = add_string(key);
+            slot.key_size = (uint16_t)key.size();
+
+            visit([&](const auto& v) {
+                using T = decay_t<decltype(v)>;
+
+                if constexpr (is_same_v<T, bool>) {
+                    slot.type = Type::BOOL;
+                    slot.b = v;
+                }
+                else if constexpr (is_same_v<T, int64_t>) {
+                    slot.type = Type::INT;
+                    slot.i = v;
+                }
+                else if constexpr (is_same_v<T, double>) {
+                    slot.type = Type::DOUBLE;
+                    slot.d = v;
+                }
+                else {
+                    slot.type = Type::STRING;
+                    slot.str.offset = add_string(v);
+                    slot.str.size = (uint32_t)v.size();
+                }
+            }, value);
+
+            for (auto i = slot.hash & (num_slots - 1); ; i = (i + 1) & (num_slots - 1)) {
+                if (slots[i].type == Type::EMPTY) {
+                    slots[i] = slot;
+                    break;
+                }
+            }
+        }
+
+        Header header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.num_entries = (uint32_t)key_values.size();
+        header.num_slots = num_slots;
+        header.strings_offset = sizeof(Header) + slots.size() * sizeof(Slot);
+        header.size = header.strings_offset + strings.size();
+
+        // Same write then rename as Config::save.
+        auto tmp_path = widen(path + ".tmp");
+
+        {
+            ofstream f(tmp_path, ios::binary | ios::trunc);
+
+            if (!f) {
+                return false;
+            }
+
+            f.write((const char*)&header, sizeof(header));
+            f.write((const char*)slots.data(), slots.size() * sizeof(Slot));
+            f.write(strings.data(), strings.size());
+            f.flush();
+
+            if (!f) {
+                return false;
+            }
+        }
+
+        return MoveFileExW(tmp_path.c_str(), widen(path).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+    }
+
+    unique_ptr<ConfigReader> BinaryConfig::load(const string& path, const string& text_path) {
+        auto binary = open(path);
+
+        if (binary != nullptr && !is_newer(text_path, path)) {
+            return binary;
+        }
+
+        auto cfg = make_unique<Config>();
+
+        if (!cfg->load(text_path)) {
+            if (binary != nullptr) {
+                return binary;
+            }
+
+            return cfg;
+        }
+
+        if (binary != nullptr) {
+            spdlog::info("{} was edited since {} was written, importing it", text_path, path);
+
+            // Can't be replaced while it's still mapped.
+            binary.reset();
+        }
+        else {
+            spdlog::info("Migrating {} to {}", text_path, path);
+        }
+
+        if (!save(*cfg, path)) {
+            spdlog::error("Failed to write {}", path);
+        }
+
+        return cfg;
+    }
+
+    optional<ConfigReader::Value> BinaryConfig::get_value(string_view key) const {
+        const auto mask = m_header->num_slots - 1;
+        const auto key_hash = hash(key);
+
+        for (auto i = key_hash & mask; ; i = (i + 1) & mask) {
+            auto& slot = m_slots[i];
+
+            if (slot.type == Type::EMPTY) {
+                return {};
+            }
+
+            if (slot.hash == key_hash && get_string(slot.key_offset, slot.key_size) == key) {
+                return get_value(slot);
+            }
+        }
+    }
+
+    bool BinaryConfig::validate() const {
+        auto file_size = m_file->get_size();
+
+        if (m_header->magic != MAGIC || m_header->version != VERSION || m_header->size != file_size) {
+            return false;
+        }
+
+        // Half full at most, so there's always an empty slot to stop a probe.
+        auto num_slots = m_header->num_slots;
+
+        if (num_slots == 0 || (num_slots & (num_slots - 1)) != 0 || m_header->num_entries >= num_slots) {
+            return false;
+        }
+
+        if (m_header->strings_offset != sizeof(Header) + (uint64_t)num_slots * sizeof(Slot) || m_header->strings_offset > file_size) {
+            return false;
+        }
+
+        // Check every reference once here so lookups don't have to.
+        auto strings_size = file_size - m_header->strings_offset;
+        uint32_t num_entries = 0;
+
+        for (uint32_t i = 0; i < num_slots; ++i) {
+            auto& slot = m_slots[i];
+
+            if (slot.type == Type::EMPTY) {
+                continue;
+            }
+
+            if (slot.type > Type::STRING || (uint64_t)slot.key_offset + slot.key_size > strings_size) {
+                return false;
+            }
+
+            if (slot.type == Type::STRING && (uint64_t)slot.str.offset + slot.str.size > strings_size) {
+                return false;
+            }
+
+            ++num_entries;
+        }
+
+        return num_entries == m_header->num_entries;
+    }
+
+    string_view BinaryConfig::get_string(uint32_t offset, uint32_t size) const {
+        return { m_strings + offset, size };
+    }
+
+    ConfigReader::Value BinaryConfig::get_value(const Slot& slot) const {
+        switch (slot.type) {
+        case Type::BOOL:
+            return slot.b;
+        case Type::INT:
+            return slot.i;
+        case Type::DOUBLE:
+            return slot.d;
+        default:
+            return string{ get_string(slot.str.offset, slot.str.size) };
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Config.hpp"
+#include "MappedFile.hpp"
+
+namespace utility {
+    // Config stored as a hash table of typed values, read straight out of a mapped file.
+    // Nothing is parsed on load, a lookup is a hash and a probe or two.
+    //
+    // File layout:
+    //   Header
+    //   Slot[num_slots], open addressing with linear probing, num_slots is a power of two
+    //   key and string value bytes, referenced by offset from strings_offset
+    class BinaryConfig : public ConfigReader {
+    public:
+        using Ptr = std::unique_ptr<BinaryConfig>;
+
+        // "RFCB"
+        static constexpr uint32_t MAGIC{ 0x42434652 };
+        static constexpr uint32_t VERSION{ 1 };
+
+        enum class Type : uint8_t {
+            EMPTY,
+            BOOL,
+            INT,
+            DOUBLE,
+            STRING,
+        };
+
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t num_entries;
+            uint32_t num_slots;
+            uint64_t strings_offset;
+            uint64_t size;
+        };
+
+        struct Slot {
+            uint64_t hash;
+            uint32_t key_offset;
+            uint16_t key_size;
+            Type type;
+            uint8_t pad;
+
+            union {
+                int64_t i;
+                double d;
+                bool b;
+
+                struct {
+                    uint32_t offset;
+                    uint32_t size;
+                } str;
+            };
+        };
+
+        // Returns nullptr if the file doesn't exist or isn't a valid binary config.
+        static Ptr open(const std::string& path);
+        static bool save(const Config& cfg, const std::string& path);
+
+        // Maps the binary config, or if there isn't one yet, or the text config at text_path was edited
+        // since it was written, loads the text config and writes it back out as binary so the next
+        // load can skip the parsing.
+        static std::unique_ptr<ConfigReader> load(const std::string& path, const std::string& text_path);
+
+        std::optional<Value> get_value(std::string_view key) const override;
+
+        auto get_num_entries() const {
+            return m_header->num_entries;
+        }
+
+    private:
+        BinaryConfig() = default;
+
+        bool validate() const;
+        std::string_view get_string(uint32_t offset, uint32_t size) const;
+        Value get_value(const Slot& slot) const;
+
+        MappedFile::Ptr m_file{};
+        const Header* m_header{ nullptr };
+        const Slot* m_slots{ nullptr };
+        const char* m_strings{ nullptr };
+    };
+}
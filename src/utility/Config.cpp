@@ -1,5 +1,14 @@
+#include <condition_variable>
 #include <fstream>
+#include <iomanip>
+#include <locale>
+#include <mutex>
 #include <sstream>
+#include <thread>
+
+#include <Windows.h>
+
+#include <spdlog/spdlog.h>
 
 #include "String.hpp"
 #include "Config.hpp"
@@ -7,6 +16,41 @@
 using namespace std;
 
 namespace utility {
+    namespace {
+        // Only takes a number if it's the whole text. Goes through the classic locale so
+        // whatever locale the game sets can't change the decimal point.
+        template <typename T>
+        optional<T> parse_number(const string& text) {
+            istringstream ss{ text };
+            ss.imbue(locale::classic());
+
+            T value{};
+
+            if (!(ss >> value) || ss.peek() != char_traits<char>::eof()) {
+                return {};
+            }
+
+            return value;
+        }
+
+        // 15 digits reads back as the same value for most doubles and doesn't turn 0.1 into 0.10000000000000001,
+        // 17 always reads back.
+        string format_double(double value) {
+            ostringstream ss{};
+            ss.imbue(locale::classic());
+            ss << setprecision(15) << value;
+
+            if (parse_number<double>(ss.str()) == value) {
+                return ss.str();
+            }
+
+            ss.str({});
+            ss << setprecision(17) << value;
+
+            return ss.str();
+        }
+    }
+
     Config::Config(const string& filePath)
         : m_key_values{}
     {
@@ -34,27 +78,55 @@ namespace utility {
             getline(ss, key, '=');
             getline(ss, value);
 
-            set(key, value);
+            if (!key.empty() && !value.empty()) {
+                m_key_values[key] = parse(value);
+            }
         }
 
         return true;
     }
 
-    bool Config::save(const string& filePath) {
-        ofstream f(widen(filePath));
+    bool Config::save(const string& filePath) const {
+        auto tmpPath = widen(filePath + ".tmp");
 
-        if (!f) {
-            return false;
+        {
+            ofstream f(tmpPath);
+
+            if (!f) {
+                return false;
+            }
+
+            for (auto& keyValue : m_key_values) {
+                f << keyValue.first << "=" << to_string(keyValue.second) << "\n";
+            }
+
+            f.flush();
+
+            if (!f) {
+                return false;
+            }
         }
 
-        for (auto& keyValue : m_key_values) {
-            f << keyValue.first << "=" << keyValue.second << endl;
+        return MoveFileExW(tmpPath.c_str(), widen(filePath).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+    }
+
+    optional<string> ConfigReader::get(string_view key) const {
+        auto value = get_value(key);
+
+        if (!value) {
+            return {};
         }
 
-        return true;
+        return to_string(*value);
     }
 
-    optional<string> Config::get(const string& key) const {
+    void Config::set(const string& key, const string& value) {
+        if (!value.empty()) {
+            set_value(key, value);
+        }
+    }
+
+    optional<Config::Value> Config::get_value(string_view key) const {
         auto search = m_key_values.find(key);
 
         if (search == m_key_values.end()) {
@@ -64,9 +136,111 @@ namespace utility {
         return search->second;
     }
 
-    void Config::set(const string& key, const string& value) {
-        if (!key.empty() && !value.empty()) {
-            m_key_values[key] = value;
+    void Config::set_value(const string& key, Value value) {
+        if (!key.empty()) {
+            m_key_values[key] = move(value);
+        }
+    }
+
+    Config::Value Config::parse(const string& text) {
+        if (text == "true") {
+            return true;
+        }
+
+        if (text == "false") {
+            return false;
+        }
+
+        if (auto i = parse_number<int64_t>(text)) {
+            return *i;
+        }
+
+        if (auto d = parse_number<double>(text)) {
+            return *d;
         }
+
+        return text;
+    }
+
+    string ConfigReader::to_string(const Value& value) {
+        return visit([](const auto& v) -> string {
+            using T = decay_t<decltype(v)>;
+
+            if constexpr (is_same_v<T, string>) {
+                return v;
+            }
+            else if constexpr (is_same_v<T, bool>) {
+                return v ? "true" : "false";
+            }
+            else if constexpr (is_same_v<T, double>) {
+                return format_double(v);
+            }
+            else {
+                return std::to_string(v);
+            }
+        }, value);
+    }
+
+    struct ConfigWriter::State {
+        string path{};
+        ConfigWriter::SaveFn save{};
+
+        mutex mtx{};
+        condition_variable cv{};
+        optional<Config> pending{};
+        bool stop{ false };
+    };
+
+    ConfigWriter::ConfigWriter(string filePath, SaveFn save)
+        : m_state{ make_shared<State>() }
+    {
+        m_state->path = move(filePath);
+        m_state->save = save ? move(save) : [](const Config& cfg, const string& path) { return cfg.save(path); };
+
+        // Detached and holding its own reference to the state, so the writer can be destroyed
+        // (even while the loader lock is held) without waiting on the disk.
+        thread{ [state = m_state]() {
+            unique_lock lock{ state->mtx };
+
+            for (;;) {
+                state->cv.wait(lock, [&]() { return state->pending.has_value() || state->stop; });
+
+                if (!state->pending) {
+                    return;
+                }
+
+                auto cfg = move(*state->pending);
+                state->pending.reset();
+
+                lock.unlock();
+
+                if (!state->save(cfg, state->path)) {
+                    spdlog::error("Failed to save {}", state->path);
+                }
+                else {
+                    spdlog::info("Saved {}", state->path);
+                }
+
+                lock.lock();
+            }
+        } }.detach();
+    }
+
+    ConfigWriter::~ConfigWriter() {
+        {
+            scoped_lock _{ m_state->mtx };
+            m_state->stop = true;
+        }
+
+        m_state->cv.notify_one();
+    }
+
+    void ConfigWriter::post(Config cfg) {
+        {
+            scoped_lock _{ m_state->mtx };
+            m_state->pending = move(cfg);
+        }
+
+        m_state->cv.notify_one();
     }
 }
@@ -1,17 +1,24 @@
 #pragma once
 
+#include <functional>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <variant>
 
 namespace utility {
-    class Config {
+    // Typed reads shared by the text config and the mapped binary one, so values can be loaded from either.
+    class ConfigReader {
     public:
-        Config(const std::string& file_path = "");
+        // Values are kept in the type they were set with, or parsed into one once when loaded from a file.
+        using Value = std::variant<std::string, bool, int64_t, double>;
 
-        bool load(const std::string& file_path);
-        bool save(const std::string& file_path);
+        virtual ~ConfigReader() = default;
+
+        virtual std::optional<Value> get_value(std::string_view key) const = 0;
 
         // Helper for differentiating between boolean and arithmetic values.
         template <typename T>
@@ -22,65 +29,72 @@ namespace utility {
 
         // get method for arithmetic types.
         template <typename T>
-        std::optional<typename std::enable_if_t<IS_ARITHMETIC_NOT_BOOL_V<T>, T>> get(const std::string& key) const {
-            auto value = get(key);
+        std::optional<typename std::enable_if_t<IS_ARITHMETIC_NOT_BOOL_V<T>, T>> get(std::string_view key) const {
+            auto value = get_value(key);
 
             if (!value) {
                 return {};
             }
 
-            // Use the correct conversion function based on the type.
-            if constexpr (std::is_integral_v<T>) {
-                if constexpr (std::is_unsigned_v<T>) {
-                    return (T)std::stoul(*value);
-                }
-                else {
-                    return (T)std::stol(*value);
-                }
+            if (auto i = std::get_if<int64_t>(&*value)) {
+                return (T)*i;
             }
-            else {
-                return (T)std::stod(*value);
+
+            if (auto d = std::get_if<double>(&*value)) {
+                return (T)*d;
             }
+
+            return {};
         }
 
         // get method for boolean types.
         template <typename T>
-        std::optional<typename std::enable_if_t<std::is_same_v<T, bool>, T>> get(const std::string& key) const {
-            auto value = get(key);
+        std::optional<typename std::enable_if_t<std::is_same_v<T, bool>, T>> get(std::string_view key) const {
+            auto value = get_value(key);
 
             if (!value) {
                 return {};
             }
 
-            if (*value == "true") {
-                return true;
-            }
-
-            if (*value == "false") {
-                return false;
+            if (auto b = std::get_if<bool>(&*value)) {
+                return *b;
             }
 
             return {};
         }
 
-        // get method for strings.
-        std::optional<std::string> get(const std::string& key) const;
+        // get method for strings. Non string values are formatted the way they'd be saved.
+        std::optional<std::string> get(std::string_view key) const;
+
+    protected:
+        static std::string to_string(const Value& value);
+    };
+
+    class Config : public ConfigReader {
+    public:
+        Config(const std::string& file_path = "");
+
+        bool load(const std::string& file_path);
+        // Writes to a temporary file and renames it over file_path, so a crash mid save never leaves a truncated config.
+        bool save(const std::string& file_path) const;
+
+        std::optional<Value> get_value(std::string_view key) const override;
 
         // set method for arithmetic types.
         template <typename T>
         void set(const std::string& key, typename std::enable_if_t<IS_ARITHMETIC_NOT_BOOL_V<T>, T> value) {
-            set(key, std::to_string(value));
+            if constexpr (std::is_integral_v<T>) {
+                set_value(key, (int64_t)value);
+            }
+            else {
+                set_value(key, (double)value);
+            }
         }
 
         // set method for boolean types.
         template <typename T>
         void set(const std::string& key, typename std::enable_if_t<std::is_same_v<T, bool>, T> value) {
-            if (value) {
-                set(key, "true");
-            }
-            else {
-                set(key, "false");
-            }
+            set_value(key, value);
         }
 
         // set method for strings.
@@ -95,6 +109,32 @@ namespace utility {
         }
 
     private:
-        std::map<std::string, std::string> m_key_values;
+        void set_value(const std::string& key, Value value);
+
+        static Value parse(const std::string& text);
+
+        std::map<std::string, Value, std::less<>> m_key_values;
+    };
+
+    // Saves configs on a thread of its own. Posting never waits on the disk, and when several
+    // configs are posted before the thread gets to them only the newest one is written.
+    // Destroying the writer doesn't wait either, anything still pending is written before the thread exits.
+    class ConfigWriter {
+    public:
+        using SaveFn = std::function<bool(const Config&, const std::string&)>;
+
+        // save defaults to Config::save.
+        explicit ConfigWriter(std::string file_path, SaveFn save = {});
+        virtual ~ConfigWriter();
+
+        ConfigWriter(const ConfigWriter& other) = delete;
+        ConfigWriter& operator=(const ConfigWriter& other) = delete;
+
+        void post(Config cfg);
+
+    private:
+        struct State;
+
+        std::shared_ptr<State> m_state;
     };
 }
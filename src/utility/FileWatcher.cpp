@@ -0,0 +1,180 @@
+#include <filesystem>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "FileWatcher.hpp"
+
+using namespace std;
+
+namespace utility {
+#ifdef _WIN32
+    // Editors tend to save in several steps, give them time to finish before reading the file.
+    static constexpr DWORD SETTLE_TIME_MS{ 100 };
+
+    struct FileWatcher::State {
+        filesystem::path path{};
+        OnChangeFn on_change{};
+        HANDLE change{ INVALID_HANDLE_VALUE };
+        HANDLE stop{ nullptr };
+
+        ~State() {
+            if (change != INVALID_HANDLE_VALUE) {
+                FindCloseChangeNotification(change);
+            }
+
+            if (stop != nullptr) {
+                CloseHandle(stop);
+            }
+        }
+
+        uint64_t get_write_time() const {
+            WIN32_FILE_ATTRIBUTE_DATA data{};
+
+            if (GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data) == FALSE) {
+                return 0;
+            }
+
+            return ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+        }
+
+        void run() {
+            auto last_write_time = get_write_time();
+            HANDLE handles[]{ stop, change };
+
+            while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0 + 1) {
+                if (WaitForSingleObject(stop, SETTLE_TIME_MS) == WAIT_OBJECT_0) {
+                    break;
+                }
+
+                // Rearm before checking, so a write landing after the check still wakes us up.
+                if (FindNextChangeNotification(change) == FALSE) {
+                    break;
+                }
+
+                // The notification is for the whole directory, only react to our file.
+                auto write_time = get_write_time();
+
+                if (write_time != last_write_time) {
+                    last_write_time = write_time;
+                    on_change();
+                }
+            }
+        }
+    };
+
+    FileWatcher::Ptr FileWatcher::create(const string& path, OnChangeFn on_change) {
+        auto state = make_shared<State>();
+        state->path = filesystem::absolute(filesystem::u8path(path));
+        state->on_change = move(on_change);
+        state->stop = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        state->change = FindFirstChangeNotificationW(state->path.parent_path().c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE);
+
+        if (state->stop == nullptr || state->change == INVALID_HANDLE_VALUE) {
+            spdlog::error("Failed to watch {} ({})", path, GetLastError());
+            return nullptr;
+        }
+
+        thread{ [state]() { state->run(); } }.detach();
+
+        auto watcher = Ptr{ new FileWatcher{} };
+        watcher->m_state = move(state);
+
+        return watcher;
+    }
+
+    FileWatcher::~FileWatcher() {
+        SetEvent(m_state->stop);
+    }
+#else
+    struct FileWatcher::State {
+        string file_name{};
+        OnChangeFn on_change{};
+        int inotify{ -1 };
+        int stop{ -1 };
+
+        ~State() {
+            if (inotify != -1) {
+                close(inotify);
+            }
+
+            if (stop != -1) {
+                close(stop);
+            }
+        }
+
+        void run() {
+            alignas(inotify_event) char buffer[4096];
+
+            for (;;) {
+                pollfd fds[]{ { stop, POLLIN, 0 }, { inotify, POLLIN, 0 } };
+
+                if (poll(fds, 2, -1) < 0 || (fds[0].revents & POLLIN) != 0) {
+                    break;
+                }
+
+                auto size = read(inotify, buffer, sizeof(buffer));
+
+                if (size <= 0) {
+                    break;
+                }
+
+                // The watch is on the whole directory, only react to our file.
+                auto changed = false;
+
+                for (auto p = buffer; p < buffer + size; ) {
+                    auto event = (const inotify_event*)p;
+
+                    if (event->len > 0 && file_name == event->name) {
+                        changed = true;
+                    }
+
+                    p += sizeof(inotify_event) + event->len;
+                }
+
+                if (changed) {
+                    on_change();
+                }
+            }
+        }
+    };
+
+    FileWatcher::Ptr FileWatcher::create(const string& path, OnChangeFn on_change) {
+        auto absolute_path = filesystem::absolute(filesystem::u8path(path));
+
+        auto state = make_shared<State>();
+        state->file_name = absolute_path.filename().string();
+        state->on_change = move(on_change);
+        state->inotify = inotify_init1(IN_CLOEXEC);
+        state->stop = eventfd(0, EFD_CLOEXEC);
+
+        // Writing in place ends with IN_CLOSE_WRITE, saving through a rename with IN_MOVED_TO.
+        if (state->inotify == -1 || state->stop == -1 ||
+            inotify_add_watch(state->inotify, absolute_path.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+            spdlog::error("Failed to watch {}", path);
+            return nullptr;
+        }
+
+        thread{ [state]() { state->run(); } }.detach();
+
+        auto watcher = Ptr{ new FileWatcher{} };
+        watcher->m_state = move(state);
+
+        return watcher;
+    }
+
+    FileWatcher::~FileWatcher() {
+        uint64_t one = 1;
+        write(m_state->stop, &one, sizeof(one));
+    }
+#endif
+}
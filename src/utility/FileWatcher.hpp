@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace utility {
+    // Watches a single file and calls on_change from a thread of its own whenever the file is
+    // written or replaced. Directory change notifications on Windows, inotify elsewhere.
+    class FileWatcher {
+    public:
+        using Ptr = std::unique_ptr<FileWatcher>;
+        using OnChangeFn = std::function<void()>;
+
+        // Returns nullptr if the file's directory can't be watched.
+        static Ptr create(const std::string& path, OnChangeFn on_change);
+
+        FileWatcher(const FileWatcher& other) = delete;
+        FileWatcher& operator=(const FileWatcher& other) = delete;
+
+        // Tells the thread to stop without waiting for it, so this is safe to run under the loader lock.
+        // on_change may still be running when this returns, it must not depend on the watcher's owner.
+        virtual ~FileWatcher();
+
+    private:
+        struct State;
+
+        FileWatcher() = default;
+
+        std::shared_ptr<State> m_state{};
+    };
+}
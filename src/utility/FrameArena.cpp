@@ -0,0 +1,66 @@
+#include <spdlog/spdlog.h>
+
+#include "FrameArena.hpp"
+
+using namespace std;
+
+namespace utility {
+    namespace {
+        constexpr size_t BLOCK_ALIGNMENT{ alignof(max_align_t) };
+    }
+
+    FrameArena::FrameArena(size_t initial_size)
+        : m_block{ (uint8_t*)pmr::new_delete_resource()->allocate(initial_size, BLOCK_ALIGNMENT) },
+        m_capacity{ initial_size }
+    {
+    }
+
+    FrameArena::~FrameArena() {
+        free_overflow();
+        pmr::new_delete_resource()->deallocate(m_block, m_capacity, BLOCK_ALIGNMENT);
+    }
+
+    void FrameArena::reset() {
+        if (!m_overflow.empty()) {
+            // Grow with some headroom so a frame that's slowly getting bigger doesn't regrow every time.
+            auto needed = m_used + m_overflow_size;
+            auto capacity = max(needed + needed / 2, m_capacity * 2);
+
+            spdlog::info("[FrameArena] Growing from {} to {} bytes", m_capacity, capacity);
+
+            free_overflow();
+            pmr::new_delete_resource()->deallocate(m_block, m_capacity, BLOCK_ALIGNMENT);
+
+            m_block = (uint8_t*)pmr::new_delete_resource()->allocate(capacity, BLOCK_ALIGNMENT);
+            m_capacity = capacity;
+        }
+
+        m_used = 0;
+    }
+
+    void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+        auto base = (uintptr_t)m_block;
+        auto offset = ((base + m_used + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+
+        if (offset <= m_capacity && bytes <= m_capacity - offset) {
+            m_used = offset + bytes;
+            return m_block + offset;
+        }
+
+        auto p = pmr::new_delete_resource()->allocate(bytes, alignment);
+
+        m_overflow.push_back({ p, bytes, alignment });
+        m_overflow_size += bytes + alignment;
+
+        return p;
+    }
+
+    void FrameArena::free_overflow() {
+        for (auto& overflow : m_overflow) {
+            pmr::new_delete_resource()->deallocate(overflow.p, overflow.size, overflow.alignment);
+        }
+
+        m_overflow.clear();
+        m_overflow_size = 0;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <spdlog/fmt/fmt.h>
+
+namespace utility {
+    // std::pmr containers and strings for memory that only has to live until the end of the frame.
+    using FrameString = std::pmr::string;
+
+    template <typename T>
+    using FrameVector = std::pmr::vector<T>;
+
+    // A bump allocator for per frame allocations, everything it hands out is freed at once by reset.
+    // Deallocating does nothing. When a frame needs more than the block holds the rest comes from the heap,
+    // and the next reset grows the block to fit, so a steady state frame allocates nothing from the heap.
+    // Not thread safe, meant for the render thread.
+    class FrameArena : public std::pmr::memory_resource {
+    public:
+        explicit FrameArena(size_t initial_size = 256 * 1024);
+        FrameArena(const FrameArena& other) = delete;
+        FrameArena(FrameArena&& other) = delete;
+        virtual ~FrameArena();
+
+        // Invalidates everything allocated since the last reset.
+        void reset();
+
+        // Bytes handed out since the last reset.
+        size_t get_used() const {
+            return m_used + m_overflow_size;
+        }
+
+        size_t get_capacity() const {
+            return m_capacity;
+        }
+
+        FrameString make_string(std::string_view s = {}) {
+            return FrameString{ s, this };
+        }
+
+        template <typename T>
+        FrameVector<T> make_vector() {
+            return FrameVector<T>{ this };
+        }
+
+        // fmt::format into a string on the arena.
+        template <typename... Args>
+        FrameString format(std::string_view format_str, const Args&... args) {
+            FrameString s{ this };
+            fmt::format_to(std::back_inserter(s), format_str, args...);
+
+            return s;
+        }
+
+        FrameArena& operator=(const FrameArena& other) = delete;
+        FrameArena& operator=(FrameArena&& other) = delete;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        struct Overflow {
+            void* p;
+            size_t size;
+            size_t alignment;
+        };
+
+        void free_overflow();
+
+        uint8_t* m_block{ nullptr };
+        size_t m_capacity{ 0 };
+        size_t m_used{ 0 };
+
+        std::vector<Overflow> m_overflow{};
+        size_t m_overflow_size{ 0 };
+    };
+}
@@ -73,4 +73,65 @@ bool FunctionHook::remove() {
     m_original = 0;
 
     return true;
-}
\ No newline at end of file
+}
+
+optional<string> FunctionHook::queue() {
+    if (m_target == 0 || m_destination == 0 || m_original == 0) {
+        return "FunctionHook not initialized";
+    }
+
+    if (auto status = MH_QueueEnableHook((LPVOID)m_target); status != MH_OK) {
+        invalidate();
+        return MH_StatusToString(status);
+    }
+
+    return {};
+}
+
+void FunctionHook::invalidate() {
+    if (m_target != 0) {
+        MH_RemoveHook((LPVOID)m_target);
+    }
+
+    m_target = 0;
+    m_destination = 0;
+    m_original = 0;
+}
+
+void FunctionHookTransaction::add(FunctionHook& hook, string_view name) {
+    m_entries.push_back({ &hook, string{ name } });
+}
+
+bool FunctionHookTransaction::commit() {
+    vector<Entry*> queued{};
+
+    for (auto& entry : m_entries) {
+        if (auto e = entry.hook->queue()) {
+            spdlog::error("Failed to queue {:s}: {:s}", entry.name, *e);
+            m_errors.push_back("Failed to hook " + entry.name);
+            continue;
+        }
+
+        queued.push_back(&entry);
+    }
+
+    if (!queued.empty()) {
+        if (auto status = MH_ApplyQueued(); status != MH_OK) {
+            spdlog::error("Failed to apply queued hooks: {:s}", MH_StatusToString(status));
+
+            for (auto entry : queued) {
+                entry->hook->invalidate();
+                m_errors.push_back("Failed to hook " + entry->name);
+            }
+        }
+        else {
+            for (auto entry : queued) {
+                spdlog::info("Hooked {:s} {:x}->{:x}", entry->name, entry->hook->m_target, entry->hook->m_destination);
+            }
+        }
+    }
+
+    m_entries.clear();
+
+    return m_errors.empty();
+}
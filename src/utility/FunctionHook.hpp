@@ -2,6 +2,10 @@
 
 #include <Windows.h>
 #include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "Address.hpp"
 
@@ -36,7 +40,47 @@ public:
     FunctionHook& operator=(FunctionHook&& other) = delete;
 
 private:
+    friend class FunctionHookTransaction;
+
+    // Like create, but only queues the hook to be enabled by MH_ApplyQueued.
+    // Returns the MinHook status on failure.
+    std::optional<std::string> queue();
+    void invalidate();
+
     uintptr_t m_target{ 0 };
     uintptr_t m_destination{ 0 };
     uintptr_t m_original{ 0 };
-};
\ No newline at end of file
+};
+
+// Enabling a hook freezes and resumes every thread in the process.
+// This queues up FunctionHook::create calls so all of them are enabled under a single freeze.
+class FunctionHookTransaction {
+public:
+    FunctionHookTransaction() = default;
+    FunctionHookTransaction(const FunctionHookTransaction& other) = delete;
+    FunctionHookTransaction(FunctionHookTransaction&& other) = delete;
+    virtual ~FunctionHookTransaction() = default;
+
+    // The name is only used for error reporting.
+    void add(FunctionHook& hook, std::string_view name);
+
+    // Enables every hook that was added. Hooks that fail are invalidated and
+    // get an entry in get_errors, the rest stay enabled.
+    bool commit();
+
+    const auto& get_errors() const {
+        return m_errors;
+    }
+
+    FunctionHookTransaction& operator=(const FunctionHookTransaction& other) = delete;
+    FunctionHookTransaction& operator=(FunctionHookTransaction&& other) = delete;
+
+private:
+    struct Entry {
+        FunctionHook* hook;
+        std::string name;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<std::string> m_errors;
+};
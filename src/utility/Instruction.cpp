@@ -0,0 +1,24 @@
+#include <cstring>
+
+#include "Instruction.hpp"
+
+namespace utility {
+    size_t decode_instruction(const uint8_t* code, size_t size, hde64s& hs) {
+        uint8_t tail[MAX_INSTRUCTION_SIZE * 2];
+
+        if (size < MAX_INSTRUCTION_SIZE) {
+            memset(tail, 0xCC, sizeof(tail));
+            memcpy(tail, code, size);
+            code = tail;
+        }
+
+        hs = {};
+        size_t length = hde64_disasm(code, &hs);
+
+        if ((hs.flags & F_ERROR) != 0 || length == 0 || length > size) {
+            return 0;
+        }
+
+        return length;
+    }
+}
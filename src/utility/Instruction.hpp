@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include <hde/hde64.h>
+}
+
+namespace utility {
+    // Longest an x86 instruction can be, and so the most hde64 will read.
+    constexpr size_t MAX_INSTRUCTION_SIZE{ 15 };
+
+    // Decodes the instruction at code, which has size bytes left. hde64 reads a full instruction's worth
+    // of bytes whatever the instruction is, so near the end they're copied out and padded with int3 first.
+    // Returns the length, 0 if it isn't a valid instruction or runs past size.
+    size_t decode_instruction(const uint8_t* code, size_t size, hde64s& hs);
+}
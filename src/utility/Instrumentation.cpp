@@ -0,0 +1,453 @@
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include <Windows.h>
+#include <malloc.h>
+
+#include "Instrumentation.hpp"
+
+using namespace std;
+
+namespace utility::instrumentation {
+    namespace {
+        constexpr size_t MAX_HITCHES{ 32 };
+        constexpr size_t MAX_STACK_DEPTH{ 32 };
+        // Threads past this many run their callbacks unwatched.
+        constexpr size_t MAX_WATCHED_THREADS{ 64 };
+
+        // Bumped by operator new, a scope's allocations are the difference between its start and end.
+        thread_local uint64_t t_allocations{ 0 };
+        thread_local uint64_t t_bytes{ 0 };
+
+        atomic<uint64_t> g_heap_allocations{ 0 };
+        atomic<uint64_t> g_heap_bytes{ 0 };
+
+        atomic<uint64_t> g_hitch_threshold_ns{ 4'000'000 };
+        atomic<uint64_t> g_frame{ 0 };
+
+        deque<Stats> g_stats{};
+        mutex g_stats_mutex{};
+
+        deque<Hitch> g_hitches{};
+
+        // The slowest scope this frame. Filled in without allocating, since scopes are measuring allocations.
+        struct Slowest {
+            uint64_t ns;
+            const Stats* stats;
+            Callback callback;
+            void* stack[MAX_STACK_DEPTH];
+            size_t depth;
+        };
+
+        Slowest g_slowest{};
+        atomic<uint64_t> g_slowest_ns{ 0 };
+        mutex g_slowest_mutex{};
+
+        void count_allocation(size_t size) {
+            ++t_allocations;
+            t_bytes += size;
+            g_heap_allocations.fetch_add(1, memory_order_relaxed);
+            g_heap_bytes.fetch_add(size, memory_order_relaxed);
+        }
+
+        uint64_t to_ns(chrono::steady_clock::time_point t) {
+            return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(t.time_since_epoch()).count();
+        }
+    }
+
+    // A thread that has run a scope. A stack taken in ~Scope would only ever show the dispatcher, so the
+    // watchdog takes it from the thread while the scope is still open instead.
+    struct WatchedThread {
+        HANDLE handle;
+        // When the scope open on the thread started, 0 while there isn't one.
+        atomic<uint64_t> start_ns;
+        // The start of the scope the stack was taken in, so a scope never picks up an older scope's stack.
+        atomic<uint64_t> sampled_ns;
+        // Only written while the thread is suspended in an open scope, and only read by that thread once
+        // the scope has closed, so the two never overlap.
+        void* stack[MAX_STACK_DEPTH];
+        size_t depth;
+    };
+
+    namespace {
+        array<WatchedThread, MAX_WATCHED_THREADS> g_watched{};
+        atomic<size_t> g_num_watched{ 0 };
+        mutex g_watched_mutex{};
+
+        thread_local WatchedThread* t_watched{ nullptr };
+        thread_local bool t_unwatched{ false };
+
+        // Doesn't allocate, the first scope on a thread is already counting.
+        WatchedThread* get_watched_thread() {
+            if (t_watched != nullptr || t_unwatched) {
+                return t_watched;
+            }
+
+            lock_guard _{ g_watched_mutex };
+
+            auto index = g_num_watched.load(memory_order_relaxed);
+            HANDLE handle{ nullptr };
+
+            if (index >= MAX_WATCHED_THREADS || !DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &handle,
+                THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT, FALSE, 0))
+            {
+                t_unwatched = true;
+                return nullptr;
+            }
+
+            g_watched[index].handle = handle;
+            g_num_watched.store(index + 1, memory_order_release);
+
+            return t_watched = &g_watched[index];
+        }
+
+        // Unwinds with the module's unwind info rather than StackWalk64, which can take the heap lock
+        // the suspended thread might be holding. Reads the thread's stack, so a bad frame can fault.
+        size_t walk_stack(CONTEXT& context, void** stack, size_t max_depth) {
+            size_t depth = 0;
+
+            __try {
+                while (depth < max_depth && context.Rip != 0) {
+                    stack[depth++] = (void*)context.Rip;
+
+                    DWORD64 image_base{ 0 };
+                    auto function = RtlLookupFunctionEntry(context.Rip, &image_base, nullptr);
+
+                    if (function == nullptr) {
+                        // Only the innermost frame can be a leaf function, with the return address right on top of the stack.
+                        if (depth > 1) {
+                            break;
+                        }
+
+                        context.Rip = *(DWORD64*)context.Rsp;
+                        context.Rsp += sizeof(DWORD64);
+                        continue;
+                    }
+
+                    void* handler_data{ nullptr };
+                    DWORD64 establisher_frame{ 0 };
+
+                    RtlVirtualUnwind(UNW_FLAG_NHANDLER, image_base, context.Rip, function, &context, &handler_data, &establisher_frame, nullptr);
+                }
+            }
+            __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH) {
+            }
+
+            return depth;
+        }
+
+        // Nothing between the suspend and the resume may allocate or lock, the thread could be holding the lock.
+        void sample(WatchedThread& thread, uint64_t start_ns) {
+            if (SuspendThread(thread.handle) == (DWORD)-1) {
+                return;
+            }
+
+            // The scope may have closed, or another opened, between the check and the suspend.
+            if (thread.start_ns.load(memory_order_acquire) == start_ns) {
+                CONTEXT context{};
+                context.ContextFlags = CONTEXT_FULL;
+
+                if (GetThreadContext(thread.handle, &context)) {
+                    thread.depth = walk_stack(context, thread.stack, MAX_STACK_DEPTH);
+                    thread.sampled_ns.store(start_ns, memory_order_release);
+                }
+            }
+
+            ResumeThread(thread.handle);
+        }
+
+        // Looks at every watched thread a few times per threshold, and takes a stack from any whose
+        // scope has been open for half of it. A scope that slow is most likely what the hitch is made of.
+        void watchdog() {
+            while (true) {
+                auto threshold_ns = g_hitch_threshold_ns.load(memory_order_relaxed);
+
+                this_thread::sleep_for(chrono::nanoseconds{ max<uint64_t>(threshold_ns / 4, 500'000) });
+
+                auto now_ns = to_ns(chrono::steady_clock::now());
+                auto num_watched = g_num_watched.load(memory_order_acquire);
+
+                for (size_t i = 0; i < num_watched; ++i) {
+                    auto& thread = g_watched[i];
+                    auto start_ns = thread.start_ns.load(memory_order_acquire);
+
+                    if (start_ns == 0 || now_ns - start_ns < threshold_ns / 2 || thread.sampled_ns.load(memory_order_relaxed) == start_ns) {
+                        continue;
+                    }
+
+                    sample(thread, start_ns);
+                }
+            }
+        }
+    }
+
+    const char* get_callback_name(Callback callback) {
+        switch (callback) {
+        case Callback::ON_FRAME:
+            return "on_frame";
+        case Callback::ON_DRAW_UI:
+            return "on_draw_ui";
+        case Callback::ON_CONFIG_LOAD:
+            return "on_config_load";
+        case Callback::ON_CONFIG_SAVE:
+            return "on_config_save";
+        case Callback::UPDATE_TRANSFORM:
+            return "on_update_transform";
+        case Callback::UPDATE_CAMERA_CONTROLLER:
+            return "on_update_camera_controller";
+        case Callback::UPDATE_CAMERA_CONTROLLER2:
+            return "on_update_camera_controller2";
+        default:
+            return "unknown";
+        }
+    }
+
+    void Stats::add(Callback callback, uint64_t ns, uint64_t allocations, uint64_t bytes) {
+        auto& counters = m_frame[(size_t)callback];
+
+        counters.calls.fetch_add(1, memory_order_relaxed);
+        counters.ns.fetch_add(ns, memory_order_relaxed);
+        counters.allocations.fetch_add(allocations, memory_order_relaxed);
+        counters.bytes.fetch_add(bytes, memory_order_relaxed);
+    }
+
+    Stats& add_stats(string_view name) {
+        // Mods are created on the render thread, but a hook on another thread could be walking the list.
+        // Adding to the end of a deque doesn't move what's already in it.
+        lock_guard _{ g_stats_mutex };
+
+        // Runs for the life of the process, like the counters.
+        if (g_stats.empty()) {
+            thread{ watchdog }.detach();
+        }
+
+        return g_stats.emplace_back(name);
+    }
+
+    const deque<Stats>& get_stats() {
+        return g_stats;
+    }
+
+    void set_hitch_threshold(chrono::microseconds threshold) {
+        g_hitch_threshold_ns.store(chrono::duration_cast<chrono::nanoseconds>(threshold).count(), memory_order_relaxed);
+    }
+
+    chrono::microseconds get_hitch_threshold() {
+        return chrono::duration_cast<chrono::microseconds>(chrono::nanoseconds{ g_hitch_threshold_ns.load(memory_order_relaxed) });
+    }
+
+    void end_frame() {
+        uint64_t total_ns{ 0 };
+
+        {
+            lock_guard _{ g_stats_mutex };
+
+            for (auto& stats : g_stats) {
+                for (size_t i = 0; i < Stats::NUM_CALLBACKS; ++i) {
+                    auto& counters = stats.m_frame[i];
+                    auto& last_frame = stats.m_last_frame[i];
+
+                    last_frame.calls = counters.calls.exchange(0, memory_order_relaxed);
+                    last_frame.ns = counters.ns.exchange(0, memory_order_relaxed);
+                    last_frame.allocations = counters.allocations.exchange(0, memory_order_relaxed);
+                    last_frame.bytes = counters.bytes.exchange(0, memory_order_relaxed);
+
+                    stats.m_peak_ns[i] = max(stats.m_peak_ns[i], last_frame.ns);
+                    total_ns += last_frame.ns;
+                }
+            }
+        }
+
+        auto frame = g_frame.fetch_add(1, memory_order_relaxed);
+
+        lock_guard _{ g_slowest_mutex };
+
+        if (total_ns >= g_hitch_threshold_ns.load(memory_order_relaxed) && g_slowest.stats != nullptr) {
+            if (g_hitches.size() >= MAX_HITCHES) {
+                g_hitches.pop_front();
+            }
+
+            g_hitches.push_back(Hitch{
+                frame, total_ns, g_slowest.stats->get_name(), g_slowest.callback, g_slowest.ns,
+                { g_slowest.stack, g_slowest.stack + g_slowest.depth }
+            });
+        }
+
+        g_slowest = {};
+        g_slowest_ns.store(0, memory_order_relaxed);
+    }
+
+    uint64_t get_frame() {
+        return g_frame.load(memory_order_relaxed);
+    }
+
+    const deque<Hitch>& get_hitches() {
+        return g_hitches;
+    }
+
+    void clear_hitches() {
+        lock_guard _{ g_slowest_mutex };
+        g_hitches.clear();
+    }
+
+    Totals get_heap_totals() {
+        return { 0, 0, g_heap_allocations.load(memory_order_relaxed), g_heap_bytes.load(memory_order_relaxed) };
+    }
+
+    Scope::Scope(Stats* stats, Callback callback)
+        : m_stats{ stats },
+        m_callback{ callback },
+        m_start{ chrono::steady_clock::now() },
+        m_allocations{ t_allocations },
+        m_bytes{ t_bytes },
+        m_thread{ stats != nullptr ? get_watched_thread() : nullptr }
+    {
+        // Nested in another scope, which is the one being watched.
+        if (m_thread != nullptr && m_thread->start_ns.load(memory_order_relaxed) != 0) {
+            m_thread = nullptr;
+        }
+
+        if (m_thread != nullptr) {
+            m_thread->start_ns.store(to_ns(m_start), memory_order_release);
+        }
+    }
+
+    Scope::~Scope() {
+        if (m_stats == nullptr) {
+            return;
+        }
+
+        // The watchdog can't take a stack from here on, so whatever it took is safe to read.
+        if (m_thread != nullptr) {
+            m_thread->start_ns.store(0, memory_order_release);
+        }
+
+        auto ns = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - m_start).count();
+
+        m_stats->add(m_callback, ns, t_allocations - m_allocations, t_bytes - m_bytes);
+
+        // Only the slowest scope of the frame is kept for the hitch report, most scopes don't get past this check.
+        if (ns <= g_slowest_ns.load(memory_order_relaxed)) {
+            return;
+        }
+
+        lock_guard _{ g_slowest_mutex };
+
+        if (ns <= g_slowest.ns) {
+            return;
+        }
+
+        g_slowest.ns = ns;
+        g_slowest.stats = m_stats;
+        g_slowest.callback = m_callback;
+        g_slowest.depth = 0;
+
+        if (m_thread != nullptr && m_thread->sampled_ns.load(memory_order_acquire) == to_ns(m_start)) {
+            g_slowest.depth = m_thread->depth;
+            copy(m_thread->stack, m_thread->stack + m_thread->depth, g_slowest.stack);
+        }
+
+        g_slowest_ns.store(ns, memory_order_relaxed);
+    }
+}
+
+#ifdef INSTRUMENTED
+// Replacing these in any one translation unit replaces them for the whole module.
+// The aligned overloads go through _aligned_malloc, whose memory has to be freed with _aligned_free.
+void* operator new(size_t size) {
+    utility::instrumentation::count_allocation(size);
+
+    if (auto p = malloc(size != 0 ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    utility::instrumentation::count_allocation(size);
+    return malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    utility::instrumentation::count_allocation(size);
+
+    if (auto p = _aligned_malloc(size != 0 ? size : 1, (size_t)alignment)) {
+        return p;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    utility::instrumentation::count_allocation(size);
+    return _aligned_malloc(size != 0 ? size : 1, (size_t)alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept {
+    return operator new(size, alignment, tag);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    _aligned_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    _aligned_free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    _aligned_free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    _aligned_free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    _aligned_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    _aligned_free(p);
+}
+#endif
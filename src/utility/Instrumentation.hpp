@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Time and heap allocations per mod callback, for builds configured with INSTRUMENTED.
+// Allocations are counted by replacing operator new and delete, so only the framework's
+// own allocations are seen, the game's go through its own allocator.
+namespace utility::instrumentation {
+    enum class Callback : uint8_t {
+        ON_FRAME,
+        ON_DRAW_UI,
+        ON_CONFIG_LOAD,
+        ON_CONFIG_SAVE,
+        UPDATE_TRANSFORM,
+        UPDATE_CAMERA_CONTROLLER,
+        UPDATE_CAMERA_CONTROLLER2,
+        COUNT,
+    };
+
+    const char* get_callback_name(Callback callback);
+
+    struct Totals {
+        uint64_t calls;
+        uint64_t ns;
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+
+    // One mod's counters. Callbacks on any thread add to the current frame,
+    // end_frame moves them over to the last frame.
+    class Stats {
+    public:
+        explicit Stats(std::string_view name)
+            : m_name{ name }
+        {
+        }
+
+        Stats(const Stats& other) = delete;
+        Stats& operator=(const Stats& other) = delete;
+
+        const auto& get_name() const {
+            return m_name;
+        }
+
+        // Render thread only.
+        const Totals& get_last_frame(Callback callback) const {
+            return m_last_frame[(size_t)callback];
+        }
+
+        // The most time spent in callback in any one frame. Render thread only.
+        uint64_t get_peak_ns(Callback callback) const {
+            return m_peak_ns[(size_t)callback];
+        }
+
+        void add(Callback callback, uint64_t ns, uint64_t allocations, uint64_t bytes);
+
+    private:
+        friend void end_frame();
+
+        struct Counters {
+            std::atomic<uint64_t> calls{ 0 };
+            std::atomic<uint64_t> ns{ 0 };
+            std::atomic<uint64_t> allocations{ 0 };
+            std::atomic<uint64_t> bytes{ 0 };
+        };
+
+        static constexpr auto NUM_CALLBACKS = (size_t)Callback::COUNT;
+
+        std::string m_name;
+        std::array<Counters, NUM_CALLBACKS> m_frame{};
+        std::array<Totals, NUM_CALLBACKS> m_last_frame{};
+        std::array<uint64_t, NUM_CALLBACKS> m_peak_ns{};
+    };
+
+    // A frame whose callbacks took longer than the hitch threshold, and the slowest callback in it.
+    struct Hitch {
+        uint64_t frame;
+        uint64_t total_ns;
+        std::string mod;
+        Callback callback;
+        uint64_t ns;
+        // Where the slowest callback was while it was still running, innermost first. Empty if it
+        // never stayed open for half the threshold, that's when the watchdog takes a look.
+        std::vector<void*> stack;
+    };
+
+    // Adds the counters for a mod. Call before any of its callbacks run, they live as long as the process.
+    Stats& add_stats(std::string_view name);
+    // Render thread only.
+    const std::deque<Stats>& get_stats();
+
+    void set_hitch_threshold(std::chrono::microseconds threshold);
+    std::chrono::microseconds get_hitch_threshold();
+
+    // Render thread, once per frame. Moves every mod's counters over to the last frame and checks for a hitch.
+    void end_frame();
+    uint64_t get_frame();
+
+    // The most recent hitches, oldest first. Render thread only.
+    const std::deque<Hitch>& get_hitches();
+    void clear_hitches();
+
+    // Everything operator new has been asked for so far, from any thread.
+    Totals get_heap_totals();
+
+    struct WatchedThread;
+
+    // Times one callback and counts the allocations made on this thread while it runs.
+    // The outermost scope on a thread is also watched, so a stack can be taken while it's running.
+    class Scope {
+    public:
+        Scope(Stats* stats, Callback callback);
+        ~Scope();
+
+        Scope(const Scope& other) = delete;
+        Scope& operator=(const Scope& other) = delete;
+
+    private:
+        Stats* m_stats;
+        Callback m_callback;
+        std::chrono::steady_clock::time_point m_start;
+        uint64_t m_allocations;
+        uint64_t m_bytes;
+        WatchedThread* m_thread;
+    };
+}
+
+#ifdef INSTRUMENTED
+#define INSTRUMENT_CALLBACK(mod, callback) \
+    ::utility::instrumentation::Scope instrumentation_scope{ (mod).get_stats(), ::utility::instrumentation::Callback::callback }
+#else
+#define INSTRUMENT_CALLBACK(mod, callback)
+#endif
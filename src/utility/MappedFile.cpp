@@ -0,0 +1,90 @@
+#include <spdlog/spdlog.h>
+
+#include "String.hpp"
+#include "MappedFile.hpp"
+
+using namespace std;
+
+namespace utility {
+    MappedFile::Ptr MappedFile::open(const string& path, size_t size) {
+        return map(path, size, false);
+    }
+
+    MappedFile::Ptr MappedFile::open_read_only(const string& path) {
+        return map(path, 0, true);
+    }
+
+    MappedFile::Ptr MappedFile::map(const string& path, size_t size, bool read_only) {
+        auto file = Ptr{ new MappedFile{} };
+
+        if (read_only) {
+            file->m_file = CreateFileW(widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        }
+        else {
+            file->m_file = CreateFileW(widen(path).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        }
+
+        if (file->m_file == INVALID_HANDLE_VALUE) {
+            // A missing file is expected when only reading.
+            if (!read_only) {
+                spdlog::error("Failed to open {} ({})", path, GetLastError());
+            }
+
+            return nullptr;
+        }
+
+        LARGE_INTEGER file_size{};
+
+        if (size == 0) {
+            if (GetFileSizeEx(file->m_file, &file_size) == FALSE || file_size.QuadPart == 0) {
+                return nullptr;
+            }
+
+            size = (size_t)file_size.QuadPart;
+        }
+        else {
+            file_size.QuadPart = (LONGLONG)size;
+
+            if (SetFilePointerEx(file->m_file, file_size, nullptr, FILE_BEGIN) == FALSE || SetEndOfFile(file->m_file) == FALSE) {
+                spdlog::error("Failed to resize {} to {} bytes ({})", path, size, GetLastError());
+                return nullptr;
+            }
+        }
+
+        file->m_mapping = CreateFileMappingW(file->m_file, nullptr, read_only ? PAGE_READONLY : PAGE_READWRITE, 0, 0, nullptr);
+
+        if (file->m_mapping == nullptr) {
+            spdlog::error("Failed to create a mapping for {} ({})", path, GetLastError());
+            return nullptr;
+        }
+
+        file->m_data = (uint8_t*)MapViewOfFile(file->m_mapping, read_only ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+        if (file->m_data == nullptr) {
+            spdlog::error("Failed to map {} ({})", path, GetLastError());
+            return nullptr;
+        }
+
+        file->m_size = size;
+
+        return file;
+    }
+
+    MappedFile::~MappedFile() {
+        if (m_data != nullptr) {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mapping != nullptr) {
+            CloseHandle(m_mapping);
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+    }
+
+    bool MappedFile::flush() {
+        return FlushViewOfFile(m_data, m_size) != FALSE;
+    }
+}
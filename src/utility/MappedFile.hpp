@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <Windows.h>
+
+namespace utility {
+    // A file mapped read/write into memory. Writes through get_data() land in the file
+    // without any explicit I/O, the OS writes the pages back on its own schedule.
+    class MappedFile {
+    public:
+        using Ptr = std::unique_ptr<MappedFile>;
+
+        // Opens or creates the file. If size is 0 the file's current size is used,
+        // otherwise the file is grown or shrunk to size first. Returns nullptr on failure.
+        static Ptr open(const std::string& path, size_t size = 0);
+        // Maps an existing file without write access, get_data() must only be read from.
+        // Returns nullptr if the file doesn't exist or is empty.
+        static Ptr open_read_only(const std::string& path);
+
+        MappedFile(const MappedFile& other) = delete;
+        MappedFile(MappedFile&& other) = delete;
+        virtual ~MappedFile();
+
+        // Ask the OS to write the dirty pages back now.
+        bool flush();
+
+        auto get_data() const {
+            return m_data;
+        }
+
+        auto get_size() const {
+            return m_size;
+        }
+
+        MappedFile& operator=(const MappedFile& other) = delete;
+        MappedFile& operator=(MappedFile&& other) = delete;
+
+    private:
+        MappedFile() = default;
+
+        static Ptr map(const std::string& path, size_t size, bool read_only);
+
+        HANDLE m_file{ INVALID_HANDLE_VALUE };
+        HANDLE m_mapping{ nullptr };
+        uint8_t* m_data{ nullptr };
+        size_t m_size{ 0 };
+    };
+}
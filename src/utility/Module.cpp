@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cctype>
+
 #include <Shlwapi.h>
 
 #include "String.hpp"
@@ -67,4 +70,30 @@ namespace utility {
 
         return {};
     }
+
+    vector<PeImport> get_imports(HMODULE module) {
+        auto size = get_module_size(module);
+
+        if (!size) {
+            return {};
+        }
+
+        return parse_pe_imports((const uint8_t*)module, *size, true);
+    }
+
+    optional<uintptr_t> find_import(HMODULE module, string_view dll, string_view function) {
+        auto equals_ignore_case = [](string_view a, string_view b) {
+            return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                return tolower((unsigned char)x) == tolower((unsigned char)y);
+            });
+        };
+
+        for (auto& entry : get_imports(module)) {
+            if (entry.name == function && equals_ignore_case(entry.module, dll)) {
+                return (uintptr_t)module + entry.slot;
+            }
+        }
+
+        return {};
+    }
 }
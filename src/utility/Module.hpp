@@ -3,9 +3,13 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <Windows.h>
 
+#include "PeImage.hpp"
+
 namespace utility {
     //
     // Module utilities.
@@ -18,4 +22,9 @@ namespace utility {
     // Note: This function doesn't validate the dll's headers so make sure you've
     // done so before calling it.
     std::optional<uintptr_t> ptr_from_rva(uint8_t* dll, uintptr_t rva);
+
+    // Everything module imports, slots are relative to module.
+    std::vector<PeImport> get_imports(HMODULE module);
+    // Address of the IAT entry module calls function from dll through. dll is matched case insensitively.
+    std::optional<uintptr_t> find_import(HMODULE module, std::string_view dll, std::string_view function);
 }
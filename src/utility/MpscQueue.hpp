@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace utility {
+    // Bounded multiple producer, single consumer queue. Neither side takes a lock;
+    // push fails instead of waiting when the queue is full.
+    // Each cell carries a sequence number telling producers and the consumer whose turn it is.
+    template <typename T>
+    class MpscQueue {
+    public:
+        // capacity is rounded up to a power of two.
+        explicit MpscQueue(size_t capacity) {
+            size_t size = 2;
+
+            while (size < capacity) {
+                size <<= 1;
+            }
+
+            m_mask = size - 1;
+            m_cells = std::make_unique<Cell[]>(size);
+
+            for (size_t i = 0; i < size; ++i) {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscQueue(const MpscQueue& other) = delete;
+        MpscQueue& operator=(const MpscQueue& other) = delete;
+
+        // Any thread.
+        bool push(const T& value) {
+            auto pos = m_head.load(std::memory_order_relaxed);
+
+            for (;;) {
+                auto& cell = m_cells[pos & m_mask];
+                auto sequence = cell.sequence.load(std::memory_order_acquire);
+                auto diff = (intptr_t)sequence - (intptr_t)pos;
+
+                if (diff == 0) {
+                    if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.value = value;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    // The consumer hasn't freed this cell yet.
+                    return false;
+                }
+                else {
+                    pos = m_head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Consumer only.
+        bool pop(T& out) {
+            auto& cell = m_cells[m_tail & m_mask];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+            if ((intptr_t)sequence - (intptr_t)(m_tail + 1) < 0) {
+                return false;
+            }
+
+            out = cell.value;
+            cell.sequence.store(m_tail + m_mask + 1, std::memory_order_release);
+            ++m_tail;
+
+            return true;
+        }
+
+        size_t get_capacity() const {
+            return m_mask + 1;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{};
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> m_cells{};
+        size_t m_mask{ 0 };
+
+        // Kept on separate cache lines so producers and the consumer don't fight over them.
+        alignas(64) std::atomic<size_t> m_head{ 0 };
+        alignas(64) size_t m_tail{ 0 };
+    };
+}
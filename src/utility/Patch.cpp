@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <Windows.h>
 
 #include "Patch.hpp"
@@ -93,3 +95,138 @@ bool Patch::toggle() {
 bool Patch::toggle(bool state) {
     return state ? enable() : disable();
 }
+
+std::unique_ptr<PatchSet> PatchSet::create() {
+    return std::make_unique<PatchSet>();
+}
+
+PatchSet::~PatchSet() {
+    disable();
+}
+
+bool PatchSet::add(uintptr_t addr, const std::vector<int16_t>& b) {
+    if (m_enabled || addr == 0 || b.empty()) {
+        return false;
+    }
+
+    m_entries.push_back({ addr, b, {} });
+    return true;
+}
+
+bool PatchSet::add_nop(uintptr_t addr, uint32_t length) {
+    return add(addr, std::vector<int16_t>(length, 0x90));
+}
+
+bool PatchSet::enable() {
+    if (m_enabled) {
+        return true;
+    }
+
+    // Backup the original bytes.
+    for (auto& entry : m_entries) {
+        if (!entry.original_bytes.empty()) {
+            continue;
+        }
+
+        entry.original_bytes.resize(entry.bytes.size());
+
+        unsigned int count = 0;
+
+        for (auto& byte : entry.original_bytes) {
+            byte = *(uint8_t*)(entry.address + count++);
+        }
+    }
+
+    return m_enabled = apply(true);
+}
+
+bool PatchSet::disable() {
+    if (!m_enabled) {
+        return true;
+    }
+
+    return !(m_enabled = !apply(false));
+}
+
+bool PatchSet::toggle() {
+    if (!m_enabled) {
+        return enable();
+    }
+
+    return !disable();
+}
+
+bool PatchSet::toggle(bool state) {
+    return state ? enable() : disable();
+}
+
+bool PatchSet::apply(bool enable) {
+    if (m_entries.empty()) {
+        return true;
+    }
+
+    static const uintptr_t page_size = []() {
+        SYSTEM_INFO info{};
+        GetSystemInfo(&info);
+        return (uintptr_t)info.dwPageSize;
+    }();
+
+    // Every page touched by the set, each one only once.
+    std::vector<uintptr_t> pages{};
+    auto lowest = UINTPTR_MAX;
+    auto highest = (uintptr_t)0;
+
+    for (const auto& entry : m_entries) {
+        auto first = entry.address & ~(page_size - 1);
+        auto last = (entry.address + entry.bytes.size() - 1) & ~(page_size - 1);
+
+        for (auto page = first; page <= last; page += page_size) {
+            pages.push_back(page);
+        }
+
+        lowest = std::min(lowest, entry.address);
+        highest = std::max(highest, entry.address + entry.bytes.size());
+    }
+
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+    // Make everything writable up front so a failure leaves the code untouched.
+    std::vector<DWORD> old_protections{};
+    old_protections.reserve(pages.size());
+
+    for (auto page : pages) {
+        auto old_protection = Patch::protect(page, page_size, PAGE_EXECUTE_READWRITE);
+
+        if (!old_protection) {
+            for (size_t i = 0; i < old_protections.size(); ++i) {
+                Patch::protect(pages[i], page_size, old_protections[i]);
+            }
+
+            return false;
+        }
+
+        old_protections.push_back(*old_protection);
+    }
+
+    for (const auto& entry : m_entries) {
+        const auto& bytes = enable ? entry.bytes : entry.original_bytes;
+        unsigned int count = 0;
+
+        for (auto byte : bytes) {
+            if (byte >= 0 && byte <= 0xFF) {
+                *(uint8_t*)(entry.address + count) = (uint8_t)byte;
+            }
+
+            ++count;
+        }
+    }
+
+    FlushInstructionCache(GetCurrentProcess(), (LPCVOID)lowest, highest - lowest);
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        Patch::protect(pages[i], page_size, old_protections[i]);
+    }
+
+    return true;
+}
@@ -32,4 +32,46 @@ private:
     std::vector<int16_t> m_bytes;
     std::vector<int16_t> m_original_bytes;
     bool m_enabled{ false };
-};
\ No newline at end of file
+};
+
+// A group of patches that are enabled and disabled together.
+// Protection is changed once per page touched and the instruction cache is flushed once,
+// no matter how many patches are in the set. If any page can't be made writable nothing is written.
+class PatchSet {
+public:
+    using Ptr = std::unique_ptr<PatchSet>;
+    static Ptr create();
+
+    PatchSet() = default;
+    PatchSet(const PatchSet& other) = delete;
+    PatchSet(PatchSet&& other) = delete;
+    virtual ~PatchSet();
+
+    // Patches can only be added while the set is disabled.
+    bool add(uintptr_t addr, const std::vector<int16_t>& b);
+    bool add_nop(uintptr_t addr, uint32_t length);
+
+    bool enable();
+    bool disable();
+    bool toggle();
+    bool toggle(bool state);
+
+    auto is_enabled() const {
+        return m_enabled;
+    }
+
+    PatchSet& operator=(const PatchSet& other) = delete;
+    PatchSet& operator=(PatchSet&& other) = delete;
+
+private:
+    struct Entry {
+        uintptr_t address;
+        std::vector<int16_t> bytes;
+        std::vector<int16_t> original_bytes;
+    };
+
+    bool apply(bool enable);
+
+    std::vector<Entry> m_entries;
+    bool m_enabled{ false };
+};
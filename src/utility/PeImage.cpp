@@ -0,0 +1,187 @@
+#include <cstring>
+
+#include "PeImage.hpp"
+
+using namespace std;
+
+namespace utility {
+    namespace {
+        constexpr uint16_t DOS_MAGIC{ 0x5A4D };
+        constexpr uint32_t NT_SIGNATURE{ 0x00004550 };
+        constexpr uint16_t PE64_MAGIC{ 0x20B };
+        constexpr size_t SECTION_HEADER_SIZE{ 40 };
+        constexpr size_t IMPORT_DESCRIPTOR_SIZE{ 20 };
+        constexpr uint64_t IMPORT_BY_ORDINAL{ 1ull << 63 };
+        constexpr uint32_t IMPORT_DIRECTORY{ 1 };
+
+        template <typename T>
+        bool read(const uint8_t* data, size_t size, size_t offset, T& out) {
+            if (offset > size || size - offset < sizeof(T)) {
+                return false;
+            }
+
+            memcpy(&out, data + offset, sizeof(T));
+            return true;
+        }
+
+        // A NUL terminated string starting at offset, nothing if it runs off the end of data.
+        optional<string> read_string(const uint8_t* data, size_t size, size_t offset) {
+            if (offset >= size) {
+                return {};
+            }
+
+            auto start = (const char*)data + offset;
+            auto end = (const char*)memchr(start, '\0', size - offset);
+
+            if (end == nullptr) {
+                return {};
+            }
+
+            return string{ start, end };
+        }
+    }
+
+    optional<size_t> PeImage::rva_to_file_offset(uint32_t rva) const {
+        for (auto& section : sections) {
+            if (rva >= section.rva && rva - section.rva < section.file_size) {
+                return (size_t)section.file_offset + (rva - section.rva);
+            }
+        }
+
+        return {};
+    }
+
+    optional<PeImage> parse_pe_image(const uint8_t* data, size_t size) {
+        if (data == nullptr) {
+            return {};
+        }
+
+        uint16_t dos_magic{};
+        uint32_t nt_offset{};
+        uint32_t signature{};
+        uint16_t num_sections{};
+        uint16_t optional_header_size{};
+        uint16_t optional_magic{};
+        uint32_t num_directories{};
+
+        if (!read(data, size, 0, dos_magic) || dos_magic != DOS_MAGIC || !read(data, size, 0x3C, nt_offset)) {
+            return {};
+        }
+
+        const size_t file_header = (size_t)nt_offset + 4;
+        const size_t optional_header = file_header + 20;
+
+        PeImage image{};
+
+        if (!read(data, size, nt_offset, signature) || signature != NT_SIGNATURE ||
+            !read(data, size, file_header + 2, num_sections) ||
+            !read(data, size, file_header + 16, optional_header_size) ||
+            !read(data, size, optional_header, optional_magic) || optional_magic != PE64_MAGIC ||
+            !read(data, size, optional_header + 24, image.base) ||
+            !read(data, size, optional_header + 56, image.size) ||
+            !read(data, size, optional_header + 108, num_directories)) {
+            return {};
+        }
+
+        // Data directories are 8 bytes each, an RVA and a size, starting at 112.
+        if (num_directories > IMPORT_DIRECTORY) {
+            const auto directory = optional_header + 112 + IMPORT_DIRECTORY * 8;
+
+            if (!read(data, size, directory, image.import_rva) || !read(data, size, directory + 4, image.import_size)) {
+                return {};
+            }
+        }
+
+        auto section_header = optional_header + optional_header_size;
+
+        for (uint16_t i = 0; i < num_sections; ++i, section_header += SECTION_HEADER_SIZE) {
+            PeSection section{};
+
+            if (!read(data, size, section_header + 8, section.virtual_size) ||
+                !read(data, size, section_header + 12, section.rva) ||
+                !read(data, size, section_header + 16, section.file_size) ||
+                !read(data, size, section_header + 20, section.file_offset) ||
+                !read(data, size, section_header + 36, section.characteristics)) {
+                return {};
+            }
+
+            image.sections.push_back(section);
+        }
+
+        return image;
+    }
+
+    vector<PeImport> parse_pe_imports(const uint8_t* data, size_t size, bool mapped) {
+        vector<PeImport> imports{};
+        auto image = parse_pe_image(data, size);
+
+        if (!image || image->import_rva == 0) {
+            return imports;
+        }
+
+        auto to_offset = [&](uint32_t rva) -> optional<size_t> {
+            if (mapped) {
+                return rva;
+            }
+
+            return image->rva_to_file_offset(rva);
+        };
+
+        for (auto descriptor = to_offset(image->import_rva); descriptor; *descriptor += IMPORT_DESCRIPTOR_SIZE) {
+            uint32_t lookup_rva{};
+            uint32_t name_rva{};
+            uint32_t slot_rva{};
+
+            if (!read(data, size, *descriptor, lookup_rva) ||
+                !read(data, size, *descriptor + 12, name_rva) ||
+                !read(data, size, *descriptor + 16, slot_rva)) {
+                break;
+            }
+
+            // The table ends with an all zero descriptor.
+            if (name_rva == 0 && slot_rva == 0) {
+                break;
+            }
+
+            auto module_offset = to_offset(name_rva);
+            auto module = module_offset ? read_string(data, size, *module_offset) : nullopt;
+
+            if (!module) {
+                break;
+            }
+
+            // Without a lookup table the IAT is all there is, which is only still
+            // the names before the loader binds it.
+            auto lookup = to_offset(lookup_rva != 0 ? lookup_rva : slot_rva);
+
+            for (uint32_t i = 0; lookup; ++i, *lookup += sizeof(uint64_t)) {
+                uint64_t thunk{};
+
+                if (!read(data, size, *lookup, thunk) || thunk == 0) {
+                    break;
+                }
+
+                PeImport entry{ *module, {}, 0, slot_rva + i * (uint32_t)sizeof(uint64_t) };
+
+                if ((thunk & IMPORT_BY_ORDINAL) != 0) {
+                    entry.ordinal = (uint16_t)thunk;
+                }
+                else {
+                    // IMAGE_IMPORT_BY_NAME, a 2 byte hint and then the name.
+                    auto name_offset = to_offset((uint32_t)thunk + 2);
+                    auto name = name_offset ? read_string(data, size, *name_offset) : nullopt;
+
+                    if (!name) {
+                        break;
+                    }
+
+                    entry.name = move(*name);
+                }
+
+                imports.push_back(move(entry));
+            }
+        }
+
+        return imports;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace utility {
+    struct PeSection {
+        uint32_t rva;
+        uint32_t virtual_size;
+        uint32_t file_offset;
+        uint32_t file_size;
+        uint32_t characteristics;
+
+        bool is_executable() const {
+            // IMAGE_SCN_MEM_EXECUTE
+            return (characteristics & 0x20000000) != 0;
+        }
+    };
+
+    // What the code indices need from a PE64 image's headers. They're read by offset rather than
+    // through the IMAGE_* structs, so images and files from disk can be indexed without Windows.
+    struct PeImage {
+        uint64_t base;
+        uint32_t size;
+        // The import directory, both 0 if there isn't one.
+        uint32_t import_rva;
+        uint32_t import_size;
+        std::vector<PeSection> sections;
+
+        // Where rva is in the file on disk, nothing if no section's raw data holds it.
+        std::optional<size_t> rva_to_file_offset(uint32_t rva) const;
+    };
+
+    struct PeImport {
+        // As written in the import descriptor, usually but not always lowercase.
+        std::string module;
+        // Empty if imported by ordinal.
+        std::string name;
+        uint16_t ordinal;
+        // RVA of the IAT entry the loader fills in with the function's address.
+        uint32_t slot;
+    };
+
+    // size is how many bytes of data can be read. Returns nothing if the headers aren't PE64.
+    std::optional<PeImage> parse_pe_image(const uint8_t* data, size_t size);
+
+    // Every function the image imports, in import table order. mapped says whether data is
+    // laid out the way the loader maps it or the way it is on disk. Descriptors or thunks that
+    // point outside of data end the walk instead of failing it.
+    std::vector<PeImport> parse_pe_imports(const uint8_t* data, size_t size, bool mapped);
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace utility {
+    // How often a hook calls one of its subscribers.
+    struct SamplingPolicy {
+        enum class Kind : uint8_t {
+            EVERY_CALL,
+            // Not subscribed at all, the hook doesn't even look at it.
+            NEVER,
+            // Every value'th call.
+            EVERY_NTH,
+            // At most once every value microseconds.
+            INTERVAL,
+            // Until the subscriber has spent value microseconds in a frame. The next frame carries
+            // on from the call it stopped at, so objects late in the update order still get their turn.
+            FRAME_BUDGET,
+        };
+
+        Kind kind{ Kind::EVERY_CALL };
+        uint32_t value{ 0 };
+
+        static SamplingPolicy every_call() {
+            return {};
+        }
+
+        static SamplingPolicy never() {
+            return { Kind::NEVER, 0 };
+        }
+
+        static SamplingPolicy every_nth(uint32_t n) {
+            return { Kind::EVERY_NTH, n };
+        }
+
+        static SamplingPolicy interval(std::chrono::microseconds interval) {
+            return { Kind::INTERVAL, (uint32_t)interval.count() };
+        }
+
+        static SamplingPolicy frame_budget(std::chrono::microseconds budget) {
+            return { Kind::FRAME_BUDGET, (uint32_t)budget.count() };
+        }
+    };
+
+    // Applies a SamplingPolicy to one subscriber. Hooks can be called from any number of threads at once,
+    // the counts are kept with relaxed atomics, so under contention the policy holds approximately.
+    class Sampler {
+    public:
+        explicit Sampler(SamplingPolicy policy)
+            : m_policy{ policy }
+        {
+        }
+
+        // Copies the policy, not how far along it is.
+        Sampler(const Sampler& other)
+            : m_policy{ other.m_policy }
+        {
+        }
+
+        Sampler& operator=(const Sampler& other) = delete;
+
+        const auto& get_policy() const {
+            return m_policy;
+        }
+
+        // Only FRAME_BUDGET subscribers need their callbacks timed and passed to spend.
+        bool is_timed() const {
+            return m_policy.kind == SamplingPolicy::Kind::FRAME_BUDGET;
+        }
+
+        // Whether this call goes to the subscriber. frame is a counter that advances once per frame.
+        bool sample(uint64_t frame) {
+            switch (m_policy.kind) {
+            case SamplingPolicy::Kind::EVERY_CALL:
+                return true;
+            case SamplingPolicy::Kind::EVERY_NTH:
+                return m_calls.fetch_add(1, std::memory_order_relaxed) % (m_policy.value != 0 ? m_policy.value : 1) == 0;
+            case SamplingPolicy::Kind::INTERVAL:
+                return sample_interval();
+            case SamplingPolicy::Kind::FRAME_BUDGET:
+                return sample_budget(frame);
+            default:
+                return false;
+            }
+        }
+
+        // How long the callbacks of a sampled call took.
+        void spend(std::chrono::nanoseconds time) {
+            m_spent.fetch_add(time.count(), std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr auto NOT_STOPPED = std::numeric_limits<uint64_t>::max();
+
+        bool sample_interval() {
+            auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            auto next = m_next.load(std::memory_order_relaxed);
+
+            if (now < next) {
+                return false;
+            }
+
+            // Only one of the threads that got here at the same time takes the call.
+            return m_next.compare_exchange_strong(next, now + m_policy.value, std::memory_order_relaxed);
+        }
+
+        bool sample_budget(uint64_t frame) {
+            if (m_frame.load(std::memory_order_relaxed) != frame && m_frame.exchange(frame, std::memory_order_relaxed) != frame) {
+                // If the budget ran out last frame, the calls before that point were covered and this one starts
+                // after them. If it didn't, start from the top, picking up what was skipped at the start of the last one.
+                auto stopped = m_stopped.exchange(NOT_STOPPED, std::memory_order_relaxed);
+
+                m_resume.store(stopped != NOT_STOPPED ? stopped : 0, std::memory_order_relaxed);
+                m_calls.store(0, std::memory_order_relaxed);
+                m_spent.store(0, std::memory_order_relaxed);
+            }
+
+            auto index = m_calls.fetch_add(1, std::memory_order_relaxed);
+
+            if (index < m_resume.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            if (m_spent.load(std::memory_order_relaxed) >= (int64_t)m_policy.value * 1000) {
+                auto expected = NOT_STOPPED;
+                m_stopped.compare_exchange_strong(expected, index, std::memory_order_relaxed);
+
+                return false;
+            }
+
+            return true;
+        }
+
+        SamplingPolicy m_policy;
+
+        // EVERY_NTH: calls so far. FRAME_BUDGET: calls so far this frame.
+        std::atomic<uint64_t> m_calls{ 0 };
+        // INTERVAL: earliest time in microseconds the next call can go through.
+        std::atomic<int64_t> m_next{ 0 };
+
+        // FRAME_BUDGET
+        std::atomic<uint64_t> m_frame{ 0 };
+        std::atomic<int64_t> m_spent{ 0 };
+        // Calls before this one were covered by the last frame.
+        std::atomic<uint64_t> m_resume{ 0 };
+        // The first call this frame that was over budget.
+        std::atomic<uint64_t> m_stopped{ NOT_STOPPED };
+    };
+}
@@ -1,4 +1,7 @@
+#include <spdlog/spdlog.h>
+
 #include "Pattern.hpp"
+#include "PeImage.hpp"
 #include "String.hpp"
 #include "Module.hpp"
 #include "Scan.hpp"
@@ -34,4 +37,64 @@ namespace utility {
 
         return address + customOffset + offset;
     }
-}
+
+    vector<ScanMatch> scan_approximate(uintptr_t start, size_t length, const string& pattern, uint32_t max_mismatches, size_t max_results) {
+        vector<ScanMatch> matches{};
+
+        if (start == 0 || length == 0) {
+            return matches;
+        }
+
+        find_approximate((const uint8_t*)start, length, buildPattern(pattern), max_mismatches, max_results, matches);
+        trim_approximate_matches(matches, max_results);
+
+        return matches;
+    }
+
+    vector<ScanMatch> scan_approximate(HMODULE module, const string& pattern, uint32_t max_mismatches, size_t max_results) {
+        vector<ScanMatch> matches{};
+
+        // Unlike the exact scan this can't stop at the first hit, so stick to sections known to be readable.
+        auto image = parse_pe_image((const uint8_t*)module, 0x1000);
+
+        if (!image) {
+            return matches;
+        }
+
+        auto bytes = buildPattern(pattern);
+
+        for (auto& section : image->sections) {
+            if (section.is_executable()) {
+                auto start = (const uint8_t*)module + section.rva;
+                find_approximate(start, section.virtual_size, bytes, max_mismatches, max_results, matches);
+            }
+        }
+
+        trim_approximate_matches(matches, max_results);
+
+        return matches;
+    }
+
+    optional<uintptr_t> scan_or_approximate(HMODULE module, const string& pattern, uint32_t max_mismatches) {
+        if (auto result = scan(module, pattern); result) {
+            return result;
+        }
+
+        auto matches = scan_approximate(module, pattern, max_mismatches, 2);
+
+        if (matches.empty()) {
+            return {};
+        }
+
+        // Two equally good candidates, no way to tell which one was meant.
+        if (matches.size() > 1 && matches[1].mismatches == matches[0].mismatches) {
+            spdlog::error("Pattern \"{}\" not found, and its closest matches are ambiguous", pattern);
+            return {};
+        }
+
+        spdlog::warn("Pattern \"{}\" not found, using the closest match at {:x} ({} bytes differ)",
+            pattern, matches[0].address, matches[0].mismatches);
+
+        return matches[0].address;
+    }
+}
\ No newline at end of file
@@ -3,14 +3,27 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <Windows.h>
 
+#include "ScanApproximate.hpp"
+
 namespace utility {
     std::optional<uintptr_t> scan(const std::string& module, const std::string& pattern);
     std::optional<uintptr_t> scan(const std::string& module, uintptr_t start, const std::string& pattern);
     std::optional<uintptr_t> scan(HMODULE module, const std::string& pattern);
     std::optional<uintptr_t> scan(uintptr_t start, size_t length, const std::string& pattern);
 
+    // Every place pattern matches with at most max_mismatches differing bytes, best first
+    // (fewest mismatches, then lowest address), at most max_results of them.
+    std::vector<ScanMatch> scan_approximate(uintptr_t start, size_t length, const std::string& pattern, uint32_t max_mismatches, size_t max_results = 16);
+    // Same, over the module's executable sections.
+    std::vector<ScanMatch> scan_approximate(HMODULE module, const std::string& pattern, uint32_t max_mismatches, size_t max_results = 16);
+
+    // An exact scan, falling back to the best approximate match when the pattern no longer matches anywhere.
+    // The fallback is only taken if that match is the single best one, and is logged so the pattern can be fixed.
+    std::optional<uintptr_t> scan_or_approximate(HMODULE module, const std::string& pattern, uint32_t max_mismatches = 2);
+
     uintptr_t calculate_absolute(uintptr_t address, uint8_t custom_offset = 4);
 }
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <limits>
+
+#include <emmintrin.h>
+
+#include "ScanApproximate.hpp"
+
+using namespace std;
+
+namespace utility {
+    void trim_approximate_matches(vector<ScanMatch>& matches, size_t max_results) {
+        sort(matches.begin(), matches.end(), [](const ScanMatch& a, const ScanMatch& b) {
+            return a.mismatches != b.mismatches ? a.mismatches < b.mismatches : a.address < b.address;
+        });
+
+        if (matches.size() > max_results) {
+            matches.resize(max_results);
+        }
+    }
+
+    // Counts mismatches for 16 consecutive start positions at once, one pattern byte at a time,
+    // and gives up on the block as soon as every position is past the limit.
+    void find_approximate(const uint8_t* data, size_t size, const vector<int16_t>& pattern,
+        uint32_t& max_mismatches, size_t max_results, vector<ScanMatch>& matches)
+    {
+        if (size < pattern.size()) {
+            return;
+        }
+
+        auto check = [&](size_t offset, uint32_t mismatches) {
+            if (mismatches > max_mismatches) {
+                return;
+            }
+
+            matches.push_back({ (uintptr_t)(data + offset), mismatches });
+
+            if (matches.size() >= MAX_APPROXIMATE_CANDIDATES) {
+                trim_approximate_matches(matches, max_results);
+
+                if (matches.size() == max_results && matches.back().mismatches < max_mismatches) {
+                    max_mismatches = matches.back().mismatches;
+                }
+            }
+        };
+
+        const auto last = size - pattern.size();
+        const auto one = _mm_set1_epi8(1);
+        size_t offset = 0;
+
+        // The counts are saturating bytes, a longer pattern could have more mismatches than they hold.
+        const auto use_blocks = pattern.size() <= numeric_limits<uint8_t>::max();
+
+        // Each block reads 15 bytes past its last start position.
+        for (; use_blocks && offset + 15 <= last; offset += 16) {
+            auto limit = _mm_set1_epi8((char)min<uint32_t>(max_mismatches, 255));
+            auto mismatches = _mm_setzero_si128();
+            auto alive = 0xFFFF;
+
+            for (size_t i = 0; i < pattern.size() && alive != 0; ++i) {
+                if (pattern[i] == -1) {
+                    continue;
+                }
+
+                auto bytes = _mm_loadu_si128((const __m128i*)(data + offset + i));
+                auto same = _mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)pattern[i]));
+
+                mismatches = _mm_adds_epu8(mismatches, _mm_andnot_si128(same, one));
+                alive = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(mismatches, limit), mismatches));
+            }
+
+            if (alive == 0) {
+                continue;
+            }
+
+            alignas(16) uint8_t counts[16];
+            _mm_store_si128((__m128i*)counts, mismatches);
+
+            for (auto lane = 0; lane < 16; ++lane) {
+                if ((alive & (1 << lane)) != 0) {
+                    check(offset + lane, counts[lane]);
+                }
+            }
+        }
+
+        // The last few positions one at a time.
+        for (; offset <= last; ++offset) {
+            uint32_t mismatches = 0;
+
+            for (size_t i = 0; i < pattern.size() && mismatches <= max_mismatches; ++i) {
+                if (pattern[i] != -1 && pattern[i] != data[offset + i]) {
+                    ++mismatches;
+                }
+            }
+
+            check(offset, mismatches);
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace utility {
+    struct ScanMatch {
+        uintptr_t address;
+        // How many of the pattern's non wildcard bytes differ.
+        uint32_t mismatches;
+    };
+
+    // Past this many candidates the worst are dropped and the mismatch limit tightened to match,
+    // so a loose pattern can't pile up millions of them.
+    constexpr size_t MAX_APPROXIMATE_CANDIDATES{ 1024 };
+
+    // Adds every place in data where pattern (bytes, -1 for wildcards) matches with at most max_mismatches
+    // differing bytes to matches. Can be called for several ranges in a row with the same matches and limit,
+    // the limit is lowered as candidates are trimmed. trim_approximate_matches gives the final list.
+    void find_approximate(const uint8_t* data, size_t size, const std::vector<int16_t>& pattern,
+        uint32_t& max_mismatches, size_t max_results, std::vector<ScanMatch>& matches);
+
+    // Best first (fewest mismatches, then lowest address), at most max_results of them.
+    void trim_approximate_matches(std::vector<ScanMatch>& matches, size_t max_results);
+}
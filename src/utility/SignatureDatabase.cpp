@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include <spdlog/spdlog.h>
+
+#include "Pattern.hpp"
+#include "PeImage.hpp"
+#include "Scan.hpp"
+#include "SignatureDatabase.hpp"
+
+using namespace std;
+
+namespace utility {
+    namespace {
+        constexpr auto NO_ANCHOR = numeric_limits<size_t>::max();
+
+        // A pair of adjacent literal bytes to look the pattern up by. Bytes that are all over x64 code
+        // are avoided where the pattern allows it, so fewer positions have candidates to check.
+        size_t find_anchor(const vector<int16_t>& bytes) {
+            auto is_common = [](int16_t b) {
+                return b == 0x00 || b == 0x48 || b == 0x89 || b == 0x8B || b == 0xCC || b == 0xFF;
+            };
+
+            auto anchor = NO_ANCHOR;
+            auto best_score = 3;
+
+            for (size_t i = 0; i + 1 < bytes.size(); ++i) {
+                if (bytes[i] == -1 || bytes[i + 1] == -1) {
+                    continue;
+                }
+
+                auto score = (int)is_common(bytes[i]) + (int)is_common(bytes[i + 1]);
+
+                if (score < best_score) {
+                    anchor = i;
+                    best_score = score;
+                }
+            }
+
+            return anchor;
+        }
+
+        optional<SignatureDatabase::Resolve> parse_resolve(const string& s) {
+            if (s == "address") {
+                return SignatureDatabase::Resolve::ADDRESS;
+            }
+
+            if (s == "rip") {
+                return SignatureDatabase::Resolve::RIP;
+            }
+
+            if (s == "call") {
+                return SignatureDatabase::Resolve::CALL;
+            }
+
+            return {};
+        }
+    }
+
+    void SignatureDatabase::add(const string& text) {
+        istringstream lines{ text };
+        string line{};
+        size_t line_number = 0;
+
+        while (getline(lines, line)) {
+            ++line_number;
+
+            if (auto comment = line.find('#'); comment != string::npos) {
+                line.erase(comment);
+            }
+
+            istringstream tokens{ line };
+            string name{};
+            Alternative alternative{};
+            string resolve{};
+            string offset{};
+
+            if (!(tokens >> name)) {
+                continue;
+            }
+
+            tokens >> alternative.build >> resolve >> offset;
+            getline(tokens, alternative.pattern);
+
+            auto kind = parse_resolve(resolve);
+
+            try {
+                alternative.offset = stoi(offset, nullptr, 0);
+            }
+            catch (const exception&) {
+                kind.reset();
+            }
+
+            if (!kind || buildPattern(alternative.pattern).empty()) {
+                spdlog::warn("[SignatureDatabase] Skipping malformed line {}: {}", line_number, line);
+                continue;
+            }
+
+            alternative.resolve = *kind;
+            m_targets[name].alternatives.push_back(move(alternative));
+        }
+    }
+
+    bool SignatureDatabase::load(const string& path) {
+        ifstream file{ path };
+
+        if (!file) {
+            return false;
+        }
+
+        stringstream text{};
+        text << file.rdbuf();
+        add(text.str());
+
+        spdlog::info("[SignatureDatabase] Loaded {}", path);
+
+        return true;
+    }
+
+    void SignatureDatabase::resolve(HMODULE module) {
+        m_module = module;
+
+        // Only the headers are read before the size is known, they fit in the first page.
+        auto image = parse_pe_image((const uint8_t*)module, 0x1000);
+
+        if (!image) {
+            spdlog::error("[SignatureDatabase] Invalid module headers");
+            return;
+        }
+
+        struct Pattern {
+            vector<int16_t> bytes;
+            size_t anchor;
+            optional<uintptr_t> match;
+        };
+
+        // Every distinct pattern once, however many targets share it.
+        vector<Pattern> patterns{};
+        unordered_map<string, size_t> pattern_ids{};
+
+        for (auto& [name, target] : m_targets) {
+            for (auto& alternative : target.alternatives) {
+                if (pattern_ids.find(alternative.pattern) != pattern_ids.end()) {
+                    continue;
+                }
+
+                auto bytes = buildPattern(alternative.pattern);
+                auto anchor = find_anchor(bytes);
+
+                if (anchor == NO_ANCHOR) {
+                    spdlog::warn("[SignatureDatabase] {}: \"{}\" needs two literal bytes in a row", name, alternative.pattern);
+                }
+
+                pattern_ids[alternative.pattern] = patterns.size();
+                patterns.push_back({ move(bytes), anchor, {} });
+            }
+        }
+
+        // Pattern ids bucketed by their anchor pair, laid out flat: bucket k is
+        // bucket_ids[bucket_first[k]] up to bucket_ids[bucket_first[k + 1]].
+        vector<uint32_t> bucket_first(0x10000 + 1);
+        vector<uint32_t> bucket_ids{};
+        size_t remaining = 0;
+
+        auto get_key = [](const uint8_t* p) {
+            return (uint32_t)p[0] | (uint32_t)p[1] << 8;
+        };
+
+        for (auto& p : patterns) {
+            if (p.anchor != NO_ANCHOR) {
+                uint8_t pair[]{ (uint8_t)p.bytes[p.anchor], (uint8_t)p.bytes[p.anchor + 1] };
+                ++bucket_first[get_key(pair) + 1];
+                ++remaining;
+            }
+        }
+
+        for (size_t i = 1; i < bucket_first.size(); ++i) {
+            bucket_first[i] += bucket_first[i - 1];
+        }
+
+        bucket_ids.resize(remaining);
+
+        auto next = bucket_first;
+
+        for (uint32_t i = 0; i < patterns.size(); ++i) {
+            auto& p = patterns[i];
+
+            if (p.anchor != NO_ANCHOR) {
+                uint8_t pair[]{ (uint8_t)p.bytes[p.anchor], (uint8_t)p.bytes[p.anchor + 1] };
+                bucket_ids[next[get_key(pair)]++] = i;
+            }
+        }
+
+        // Sections come in address order, so the first match found for a pattern is the one utility::scan would find.
+        for (auto& section : image->sections) {
+            if (remaining == 0) {
+                break;
+            }
+
+            if (!section.is_executable() || section.rva >= image->size) {
+                continue;
+            }
+
+            auto code = (const uint8_t*)module + section.rva;
+            auto size = (size_t)min(section.virtual_size, image->size - section.rva);
+
+            for (size_t i = 0; i + 1 < size && remaining > 0; ++i) {
+                auto key = get_key(code + i);
+
+                for (auto j = bucket_first[key]; j < bucket_first[key + 1]; ++j) {
+                    auto& p = patterns[bucket_ids[j]];
+
+                    if (p.match || i < p.anchor || i - p.anchor + p.bytes.size() > size) {
+                        continue;
+                    }
+
+                    auto start = code + i - p.anchor;
+                    auto matched = true;
+
+                    for (size_t k = 0; k < p.bytes.size(); ++k) {
+                        if (p.bytes[k] != -1 && p.bytes[k] != start[k]) {
+                            matched = false;
+                            break;
+                        }
+                    }
+
+                    if (matched) {
+                        p.match = (uintptr_t)start;
+                        --remaining;
+                    }
+                }
+            }
+        }
+
+        for (auto& [name, target] : m_targets) {
+            target.address.reset();
+
+            for (size_t i = 0; i < target.alternatives.size() && !target.address; ++i) {
+                auto& alternative = target.alternatives[i];
+                auto& match = patterns[pattern_ids[alternative.pattern]].match;
+
+                if (match) {
+                    target.address = resolve_match(*match, alternative);
+                    target.alternative = i;
+                }
+            }
+
+            if (target.address) {
+                spdlog::info("[SignatureDatabase] {}: {:x} ({})", name, *target.address, target.alternatives[target.alternative].build);
+            }
+            else {
+                spdlog::warn("[SignatureDatabase] {}: not found", name);
+            }
+        }
+    }
+
+    optional<uintptr_t> SignatureDatabase::get(const string& name) const {
+        auto it = m_targets.find(name);
+
+        if (it == m_targets.end()) {
+            spdlog::error("[SignatureDatabase] Unknown target {}", name);
+            return {};
+        }
+
+        return it->second.address;
+    }
+
+    optional<uintptr_t> SignatureDatabase::get_approximate(const string& name, uint32_t max_mismatches) const {
+        auto it = m_targets.find(name);
+
+        if (it == m_targets.end() || it->second.address || m_module == nullptr) {
+            return get(name);
+        }
+
+        for (auto& alternative : it->second.alternatives) {
+            if (auto match = scan_or_approximate(m_module, alternative.pattern, max_mismatches); match) {
+                if (auto address = resolve_match(*match, alternative); address) {
+                    return address;
+                }
+            }
+        }
+
+        return {};
+    }
+
+    optional<uintptr_t> SignatureDatabase::resolve_match(uintptr_t match, const Alternative& alternative) {
+        auto address = match + alternative.offset;
+
+        switch (alternative.resolve) {
+        case Resolve::RIP:
+            return calculate_absolute(address);
+        case Resolve::CALL:
+            // An approximate match, or a mistake in the database, could put something else here.
+            if (*(uint8_t*)address != 0xE8 && *(uint8_t*)address != 0xE9) {
+                return {};
+            }
+
+            return calculate_absolute(address + 1);
+        default:
+            return address;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Windows.h>
+
+namespace utility {
+    // Named code locations and the patterns that find them, loaded from text instead of
+    // being spread across the mods. One target per line, alternatives for other game builds
+    // on further lines with the same name, tried in the order they were added:
+    //
+    //     # name           build  resolve  offset  pattern
+    //     UpdateTransform  v2     call     0       E8 ? ? ? ? 48 8B 5B ? 48 85 DB
+    //
+    // resolve is what to do with the match plus offset:
+    //     address  use it as is.
+    //     rip      read the rel32 there, the address of something the instruction references.
+    //     call     it's an E8/E9, the function it calls or jumps to.
+    class SignatureDatabase {
+    public:
+        enum class Resolve : uint8_t {
+            ADDRESS,
+            RIP,
+            CALL,
+        };
+
+        struct Alternative {
+            // Which game build the pattern was written for, only used for logging.
+            std::string build;
+            std::string pattern;
+            int32_t offset;
+            Resolve resolve;
+        };
+
+        struct Target {
+            std::vector<Alternative> alternatives{};
+            // Filled in by resolve.
+            std::optional<uintptr_t> address{};
+            // Which alternative it was resolved with.
+            size_t alternative{ 0 };
+        };
+
+        // Adds the targets in text. Lines that don't parse are logged and skipped.
+        void add(const std::string& text);
+        // Same, from a file. False if it couldn't be read.
+        bool load(const std::string& path);
+
+        // Resolves every target at once: all the patterns are matched in a single pass
+        // over the module's code, keyed on a pair of their bytes.
+        void resolve(HMODULE module);
+
+        // Where the target was resolved to, if anything matched it.
+        std::optional<uintptr_t> get(const std::string& name) const;
+        // Same, but if none of its patterns matched exactly the closest match of each is tried
+        // as well (see utility::scan_or_approximate). That scans the module again, so only
+        // use it for targets that are worth the wait and safe to get slightly wrong.
+        std::optional<uintptr_t> get_approximate(const std::string& name, uint32_t max_mismatches = 2) const;
+
+        const auto& get_targets() const {
+            return m_targets;
+        }
+
+    private:
+        static std::optional<uintptr_t> resolve_match(uintptr_t match, const Alternative& alternative);
+
+        HMODULE m_module{ nullptr };
+        std::unordered_map<std::string, Target> m_targets{};
+    };
+}
@@ -0,0 +1,491 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include <spdlog/spdlog.h>
+
+#include "Instruction.hpp"
+#include "PeImage.hpp"
+#include "SignatureIndex.hpp"
+
+#ifdef _WIN32
+#include "MappedFile.hpp"
+#include "String.hpp"
+#endif
+
+using namespace std;
+
+namespace utility {
+    namespace {
+        // Same format utility::scan takes, ? for a wildcard. Anything that isn't a hex byte is skipped.
+        vector<int16_t> parse_pattern(const string& pattern) {
+            vector<int16_t> bytes{};
+
+            for (size_t i = 0; i < pattern.size(); ++i) {
+                if (pattern[i] == '?') {
+                    bytes.push_back(-1);
+
+                    // Allow "??" as well.
+                    if (i + 1 < pattern.size() && pattern[i + 1] == '?') {
+                        ++i;
+                    }
+
+                    continue;
+                }
+
+                if (!isxdigit((unsigned char)pattern[i]) || i + 1 >= pattern.size() || !isxdigit((unsigned char)pattern[i + 1])) {
+                    continue;
+                }
+
+                bytes.push_back((int16_t)stoul(pattern.substr(i, 2), nullptr, 16));
+                ++i;
+            }
+
+            return bytes;
+        }
+
+        string to_pattern_string(const vector<int16_t>& pattern) {
+            static constexpr char DIGITS[]{ "0123456789ABCDEF" };
+
+            string result{};
+
+            for (auto b : pattern) {
+                if (!result.empty()) {
+                    result += ' ';
+                }
+
+                if (b == -1) {
+                    result += '?';
+                }
+                else {
+                    result += DIGITS[b >> 4];
+                    result += DIGITS[b & 0xF];
+                }
+            }
+
+            return result;
+        }
+
+        size_t get_immediate_size(const hde64s& hs) {
+            if ((hs.flags & F_IMM64) != 0) {
+                return 8;
+            }
+
+            if ((hs.flags & F_IMM32) != 0) {
+                return 4;
+            }
+
+            if ((hs.flags & F_IMM16) != 0) {
+                return 2;
+            }
+
+            return (hs.flags & F_IMM8) != 0 ? 1 : 0;
+        }
+
+        // Everything from the first executable section to the end of the last, which is exactly
+        // the range a scan over the module would find code matches in. Nothing past limit is included.
+        optional<pair<size_t, size_t>> get_code_range(const PeImage& image, size_t limit) {
+            size_t first = limit;
+            size_t last = 0;
+
+            for (auto& section : image.sections) {
+                if (section.is_executable() && section.rva < limit) {
+                    first = min<size_t>(first, section.rva);
+                    last = max<size_t>(last, min<size_t>((size_t)section.rva + section.virtual_size, limit));
+                }
+            }
+
+            if (first >= last || last - first > numeric_limits<uint32_t>::max()) {
+                return {};
+            }
+
+            return make_pair(first, last);
+        }
+
+        bool is_relative_branch(const hde64s& hs) {
+            if (hs.opcode == 0x0F) {
+                // jcc rel32
+                return (hs.opcode2 & 0xF0) == 0x80;
+            }
+
+            // call, jmp, jmp rel8, jcc rel8, loop/jrcxz
+            return hs.opcode == 0xE8 || hs.opcode == 0xE9 || hs.opcode == 0xEB || (hs.opcode & 0xF0) == 0x70 || (hs.opcode >= 0xE0 && hs.opcode <= 0xE3);
+        }
+    }
+
+#ifdef _WIN32
+    SignatureIndex::Ptr SignatureIndex::create(HMODULE module) {
+        // Only the headers are read before the size is known, they fit in the first page.
+        auto image = parse_pe_image((const uint8_t*)module, 0x1000);
+
+        if (!image) {
+            spdlog::error("[SignatureIndex] Invalid module headers");
+            return nullptr;
+        }
+
+        wchar_t path[MAX_PATH]{ 0 };
+        MappedFile::Ptr file{};
+
+        if (auto length = GetModuleFileNameW(module, path, MAX_PATH); length > 0 && length < MAX_PATH) {
+            file = MappedFile::open_read_only(narrow(path));
+        }
+
+        if (file != nullptr) {
+            if (auto index = create_from_file(file->get_data(), file->get_size(), (uintptr_t)module)) {
+                return index;
+            }
+        }
+
+        spdlog::warn("[SignatureIndex] Couldn't read the module's file, indexing the loaded code, hooks included");
+
+        return create((const uint8_t*)module, image->size, (uintptr_t)module);
+    }
+#endif
+
+    SignatureIndex::Ptr SignatureIndex::create_from_image(const uint8_t* image, size_t size) {
+        auto headers = parse_pe_image(image, size);
+
+        if (!headers) {
+            spdlog::error("[SignatureIndex] Invalid PE headers");
+            return nullptr;
+        }
+
+        return create(image, size, (uintptr_t)headers->base);
+    }
+
+    SignatureIndex::Ptr SignatureIndex::create_from_file(const uint8_t* data, size_t size, uintptr_t base) {
+        auto headers = parse_pe_image(data, size);
+
+        if (!headers) {
+            spdlog::error("[SignatureIndex] Invalid PE headers");
+            return nullptr;
+        }
+
+        auto range = get_code_range(*headers, headers->size);
+
+        if (!range) {
+            spdlog::error("[SignatureIndex] No code to index");
+            return nullptr;
+        }
+
+        // Lay the raw data out the way the loader would. Whatever isn't backed by the file is zero once mapped.
+        auto [first, last] = *range;
+        vector<uint8_t> code(last - first);
+
+        for (auto& section : headers->sections) {
+            if (section.file_offset >= size) {
+                continue;
+            }
+
+            auto section_first = max<size_t>(section.rva, first);
+            auto section_last = min<size_t>({ (size_t)section.rva + min(section.file_size, section.virtual_size), last, section.rva + (size - section.file_offset) });
+
+            if (section_first >= section_last) {
+                continue;
+            }
+
+            auto source = data + section.file_offset + (section_first - section.rva);
+            copy(source, source + (section_last - section_first), code.begin() + (section_first - first));
+        }
+
+        return create(move(code), (base != 0 ? base : (uintptr_t)headers->base) + first);
+    }
+
+    SignatureIndex::Ptr SignatureIndex::create(const uint8_t* image, size_t size, uintptr_t base) {
+        auto headers = parse_pe_image(image, size);
+
+        if (!headers) {
+            return nullptr;
+        }
+
+        auto range = get_code_range(*headers, size);
+
+        if (!range) {
+            spdlog::error("[SignatureIndex] No code to index");
+            return nullptr;
+        }
+
+        return create(vector<uint8_t>(image + range->first, image + range->second), base + range->first);
+    }
+
+    SignatureIndex::Ptr SignatureIndex::create(vector<uint8_t> code, uintptr_t base) {
+        auto index = Ptr{ new SignatureIndex{} };
+        index->m_base = base;
+        index->m_code = move(code);
+        index->build_suffix_array();
+
+        spdlog::info("[SignatureIndex] Indexed {} bytes of code", index->m_code.size());
+
+        return index;
+    }
+
+    size_t SignatureIndex::count(const string& pattern, size_t limit) const {
+        size_t count = 0;
+        match(parse_pattern(pattern), limit, nullptr, count);
+
+        return count;
+    }
+
+    vector<uintptr_t> SignatureIndex::find_all(const string& pattern, size_t limit) const {
+        vector<uint32_t> offsets{};
+        size_t count = 0;
+
+        match(parse_pattern(pattern), limit, &offsets, count);
+        sort(offsets.begin(), offsets.end());
+
+        vector<uintptr_t> addresses{};
+        addresses.reserve(offsets.size());
+
+        for (auto offset : offsets) {
+            addresses.push_back(m_base + offset);
+        }
+
+        return addresses;
+    }
+
+    optional<string> SignatureIndex::make_signature(uintptr_t address, size_t max_length) const {
+        if (address < m_base || address - m_base >= m_code.size()) {
+            return {};
+        }
+
+        vector<int16_t> pattern{};
+
+        // Grow the pattern one instruction at a time, checking after every byte that can narrow it down.
+        for (size_t offset = address - m_base; offset < m_code.size() && pattern.size() < max_length; ) {
+            hde64s hs{};
+            auto length = decode_instruction(&m_code[offset], m_code.size() - offset, hs);
+
+            // Not an instruction, or one cut off by the end of the code. Take it a byte at a time.
+            if (length == 0) {
+                hs = {};
+                length = 1;
+            }
+
+            // The operand that changes when the code moves, if there is one. Immediates come last,
+            // and a RIP-relative displacement sits right before them.
+            auto immediate_size = get_immediate_size(hs);
+            size_t wildcard_first = length;
+            size_t wildcard_size = 0;
+
+            if (is_relative_branch(hs) && length >= immediate_size) {
+                wildcard_first = length - immediate_size;
+                wildcard_size = immediate_size;
+            }
+            else if ((hs.flags & F_MODRM) != 0 && hs.modrm_mod == 0 && hs.modrm_rm == 5 && length >= immediate_size + 4) {
+                wildcard_first = length - immediate_size - 4;
+                wildcard_size = 4;
+            }
+            else if ((hs.flags & F_IMM64) != 0 && length >= immediate_size) {
+                wildcard_first = length - immediate_size;
+                wildcard_size = immediate_size;
+            }
+
+            for (size_t i = 0; i < length && pattern.size() < max_length; ++i) {
+                if (i >= wildcard_first && i < wildcard_first + wildcard_size) {
+                    pattern.push_back(-1);
+                    continue;
+                }
+
+                pattern.push_back(m_code[offset + i]);
+
+                size_t count = 0;
+                match(pattern, 2, nullptr, count);
+
+                if (count == 1) {
+                    return to_pattern_string(pattern);
+                }
+            }
+
+            offset += length;
+        }
+
+        return {};
+    }
+
+    // Prefix doubling: after the pass for k, suffixes are sorted by their first 2k bytes
+    // and rank holds which group of equal 2k byte prefixes each one is in.
+    void SignatureIndex::build_suffix_array() {
+        const auto n = (uint32_t)m_code.size();
+
+        m_suffixes.resize(n);
+
+        if (n == 0) {
+            return;
+        }
+
+        vector<uint32_t> rank(n);
+        vector<uint32_t> tmp(n);
+        vector<uint32_t> counts(max<uint32_t>(n, 256) + 1);
+
+        // First pass, a counting sort on the first byte.
+        for (uint32_t i = 0; i < n; ++i) {
+            rank[i] = m_code[i];
+            ++counts[rank[i] + 1];
+        }
+
+        for (size_t i = 1; i < counts.size(); ++i) {
+            counts[i] += counts[i - 1];
+        }
+
+        for (uint32_t i = 0; i < n; ++i) {
+            m_suffixes[counts[rank[i]]++] = i;
+        }
+
+        uint32_t num_groups = 256;
+
+        for (uint32_t k = 1; k < n; k <<= 1) {
+            // Order by the second half. Suffixes too short to have one come first.
+            uint32_t j = 0;
+
+            for (auto i = n - k; i < n; ++i) {
+                tmp[j++] = i;
+            }
+
+            for (auto suffix : m_suffixes) {
+                if (suffix >= k) {
+                    tmp[j++] = suffix - k;
+                }
+            }
+
+            // Then a stable counting sort on the first half.
+            fill(counts.begin(), counts.begin() + num_groups + 1, 0);
+
+            for (uint32_t i = 0; i < n; ++i) {
+                ++counts[rank[i] + 1];
+            }
+
+            for (uint32_t i = 1; i <= num_groups; ++i) {
+                counts[i] += counts[i - 1];
+            }
+
+            for (auto suffix : tmp) {
+                m_suffixes[counts[rank[suffix]]++] = suffix;
+            }
+
+            // Regroup by both halves.
+            auto second_half = [&](uint32_t suffix) -> int64_t {
+                return suffix + k < n ? rank[suffix + k] : -1;
+            };
+
+            tmp[m_suffixes[0]] = 0;
+            num_groups = 1;
+
+            for (uint32_t i = 1; i < n; ++i) {
+                auto a = m_suffixes[i - 1];
+                auto b = m_suffixes[i];
+
+                if (rank[a] != rank[b] || second_half(a) != second_half(b)) {
+                    ++num_groups;
+                }
+
+                tmp[b] = num_groups - 1;
+            }
+
+            rank.swap(tmp);
+
+            if (num_groups == n) {
+                break;
+            }
+        }
+    }
+
+    pair<size_t, size_t> SignatureIndex::find_range(const uint8_t* bytes, size_t size) const {
+        // <0 if the suffix sorts before bytes, 0 if it starts with them.
+        auto compare = [&](uint32_t suffix) {
+            auto length = min(size, m_code.size() - suffix);
+            auto result = memcmp(&m_code[suffix], bytes, length);
+
+            if (result != 0) {
+                return result;
+            }
+
+            return length < size ? -1 : 0;
+        };
+
+        auto first = partition_point(m_suffixes.begin(), m_suffixes.end(), [&](uint32_t s) { return compare(s) < 0; });
+        auto last = partition_point(first, m_suffixes.end(), [&](uint32_t s) { return compare(s) == 0; });
+
+        return { first - m_suffixes.begin(), last - m_suffixes.begin() };
+    }
+
+    void SignatureIndex::match(const vector<int16_t>& pattern, size_t limit, vector<uint32_t>* out, size_t& count) const {
+        count = 0;
+
+        if (pattern.empty() || pattern.size() > m_code.size()) {
+            return;
+        }
+
+        // Look up every run of literal bytes and only check the candidates of the rarest one.
+        vector<uint8_t> bytes(pattern.size());
+        optional<Literal> rarest{};
+        pair<size_t, size_t> rarest_range{};
+
+        for (size_t i = 0; i < pattern.size(); ) {
+            if (pattern[i] == -1) {
+                ++i;
+                continue;
+            }
+
+            Literal literal{ i, 0 };
+
+            for (; i < pattern.size() && pattern[i] != -1; ++i) {
+                bytes[i] = (uint8_t)pattern[i];
+                ++literal.size;
+            }
+
+            auto range = find_range(&bytes[literal.offset], literal.size);
+
+            if (!rarest || range.second - range.first < rarest_range.second - rarest_range.first) {
+                rarest = literal;
+                rarest_range = range;
+            }
+        }
+
+        // All wildcards, matches everywhere.
+        if (!rarest) {
+            for (size_t offset = 0; offset + pattern.size() <= m_code.size() && count < limit; ++offset) {
+                if (out != nullptr) {
+                    out->push_back((uint32_t)offset);
+                }
+
+                ++count;
+            }
+
+            return;
+        }
+
+        for (auto i = rarest_range.first; i < rarest_range.second && count < limit; ++i) {
+            auto suffix = m_suffixes[i];
+
+            if (suffix < rarest->offset) {
+                continue;
+            }
+
+            auto offset = suffix - rarest->offset;
+
+            if (!matches_at(pattern, offset)) {
+                continue;
+            }
+
+            if (out != nullptr) {
+                out->push_back((uint32_t)offset);
+            }
+
+            ++count;
+        }
+    }
+
+    bool SignatureIndex::matches_at(const vector<int16_t>& pattern, size_t offset) const {
+        if (offset + pattern.size() > m_code.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern[i] != -1 && pattern[i] != m_code[offset + i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace utility {
+    // A suffix array over a module's code sections. Checking how often a pattern occurs is a
+    // binary search plus a check of the few candidates it leaves, instead of a scan of the whole module,
+    // which is what makes generating the shortest unique signature for an address practical.
+    //
+    // Building it takes about 16 bytes per byte of code, keeping it 5.
+    class SignatureIndex {
+    public:
+        using Ptr = std::unique_ptr<SignatureIndex>;
+
+#ifdef _WIN32
+        // Index a module loaded in this process from its file on disk, so the hooks and patches already
+        // in its code don't end up in signatures. Addresses are where the module is loaded.
+        // Falls back to a copy of the loaded code if the file can't be read.
+        static Ptr create(HMODULE module);
+#endif
+        // Index an image dumped from memory, laid out the way it was mapped.
+        // Addresses are relative to the image base in its headers.
+        static Ptr create_from_image(const uint8_t* image, size_t size);
+        // Index a PE64 file as read from disk, its sections placed the way they'd be mapped.
+        // Addresses are relative to base, or to the image base in its headers if base is 0.
+        static Ptr create_from_file(const uint8_t* data, size_t size, uintptr_t base = 0);
+
+        SignatureIndex(const SignatureIndex& other) = delete;
+        SignatureIndex& operator=(const SignatureIndex& other) = delete;
+        virtual ~SignatureIndex() = default;
+
+        // How many places in the code pattern ("48 8B ? ? E8") matches, counting no further than limit.
+        size_t count(const std::string& pattern, size_t limit = std::numeric_limits<size_t>::max()) const;
+        // Where pattern matches, in address order.
+        std::vector<uintptr_t> find_all(const std::string& pattern, size_t limit = std::numeric_limits<size_t>::max()) const;
+
+        bool is_unique(const std::string& pattern) const {
+            return count(pattern, 2) == 1;
+        }
+
+        // The shortest pattern starting at address that matches nowhere else. Relative branch targets and
+        // RIP-relative displacements are wildcarded, since they change whenever the code around them moves,
+        // and so are 64 bit immediates, which are usually addresses the loader relocates.
+        // Nothing if the pattern still isn't unique after max_length bytes.
+        std::optional<std::string> make_signature(uintptr_t address, size_t max_length = 64) const;
+
+    private:
+        // A run of pattern bytes without wildcards.
+        struct Literal {
+            size_t offset;
+            size_t size;
+        };
+
+        SignatureIndex() = default;
+
+        static Ptr create(const uint8_t* image, size_t size, uintptr_t base);
+        static Ptr create(std::vector<uint8_t> code, uintptr_t base);
+
+        void build_suffix_array();
+
+        // Suffixes starting with bytes, as a range of m_suffixes.
+        std::pair<size_t, size_t> find_range(const uint8_t* bytes, size_t size) const;
+        void match(const std::vector<int16_t>& pattern, size_t limit, std::vector<uint32_t>* out, size_t& count) const;
+        bool matches_at(const std::vector<int16_t>& pattern, size_t offset) const;
+
+        // Address of m_code[0].
+        uintptr_t m_base{ 0 };
+        std::vector<uint8_t> m_code{};
+        std::vector<uint32_t> m_suffixes{};
+    };
+}
@@ -0,0 +1,102 @@
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#include "Module.hpp"
+#include "Patch.hpp"
+#endif
+
+#include "SlotHook.hpp"
+
+using namespace std;
+
+SlotHook::SlotHook(Address slot, Address destination)
+    : m_slot{ slot.as<uintptr_t*>() },
+    m_destination{ destination }
+{
+    if (m_slot == nullptr || m_destination == 0) {
+        spdlog::error("Failed to hook slot {:p}", slot.ptr());
+        return;
+    }
+
+    m_original = *m_slot;
+
+    spdlog::info("Slot hook init successful {:p}: {:x}->{:x}", slot.ptr(), m_original, m_destination);
+}
+
+SlotHook::~SlotHook() {
+    remove();
+}
+
+bool SlotHook::create() {
+    if (m_original == 0) {
+        spdlog::error("SlotHook not initialized");
+        return false;
+    }
+
+    if (m_enabled) {
+        return true;
+    }
+
+    // Somebody else replaced it since we read it, chaining onto a stale original would skip them.
+    if (!swap(m_original, m_destination)) {
+        spdlog::error("Failed to hook slot {:p}", (void*)m_slot);
+
+        m_original = 0;
+        return false;
+    }
+
+    m_enabled = true;
+
+    spdlog::info("Hooked slot {:p}: {:x}->{:x}", (void*)m_slot, m_original, m_destination);
+    return true;
+}
+
+bool SlotHook::remove() {
+    if (!m_enabled) {
+        return true;
+    }
+
+    // If another hook went in on top of ours it still calls us, so we can't be taken out from under it.
+    if (!swap(m_destination, m_original)) {
+        spdlog::error("Failed to unhook slot {:p}, it was hooked again", (void*)m_slot);
+        return false;
+    }
+
+    // The original stays, so the hook can be created again.
+    m_enabled = false;
+
+    return true;
+}
+
+bool SlotHook::swap(uintptr_t expected, uintptr_t desired) {
+#ifdef _WIN32
+    // vtables and the IAT usually live in read only pages.
+    auto old_protection = Patch::protect((uintptr_t)m_slot, sizeof(uintptr_t), PAGE_READWRITE);
+
+    if (!old_protection) {
+        return false;
+    }
+
+    // A single aligned store, callers on other threads see either the old pointer or the new one.
+    auto previous = InterlockedCompareExchangePointer((PVOID*)m_slot, (PVOID)desired, (PVOID)expected);
+
+    Patch::protect((uintptr_t)m_slot, sizeof(uintptr_t), *old_protection);
+
+    return (uintptr_t)previous == expected;
+#else
+    // Only the tests build this elsewhere, with slots in ordinary writable memory.
+    return __atomic_compare_exchange_n(m_slot, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+VtableHook::VtableHook(Address object, size_t index, Address destination)
+    : SlotHook{ object.ptr() != nullptr ? Address{ *object.as<uintptr_t**>() + index } : Address{}, destination }
+{
+}
+
+#ifdef _WIN32
+IatHook::IatHook(HMODULE module, string_view dll, string_view function, Address destination)
+    : SlotHook{ utility::find_import(module, dll, function).value_or(0), destination }
+{
+}
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "Address.hpp"
+
+// Hooks a function by replacing a pointer its callers go through instead of patching its code.
+// Nothing gets relocated and no threads get suspended, enabling it is a single pointer swap,
+// and calls cost no more than the detour itself. Only calls made through that pointer are caught.
+// Same interface as FunctionHook.
+class SlotHook {
+public:
+    SlotHook() = delete;
+    SlotHook(const SlotHook& other) = delete;
+    SlotHook(SlotHook&& other) = delete;
+    // slot is the address of the function pointer to replace.
+    SlotHook(Address slot, Address destination);
+    virtual ~SlotHook();
+
+    bool create();
+
+    // Called automatically by the destructor, but you can call it explicitly
+    // if you need to remove the hook.
+    bool remove();
+
+    auto get_original() const {
+        return m_original;
+    }
+
+    template <typename T>
+    T* get_original() const {
+        return (T*)m_original;
+    }
+
+    auto is_valid() const {
+        return m_original != 0;
+    }
+
+    SlotHook& operator=(const SlotHook& other) = delete;
+    SlotHook& operator=(SlotHook&& other) = delete;
+
+private:
+    // Swaps the slot from expected to desired, false if it didn't hold expected or can't be written.
+    bool swap(uintptr_t expected, uintptr_t desired);
+
+    uintptr_t* m_slot{ nullptr };
+    uintptr_t m_destination{ 0 };
+    uintptr_t m_original{ 0 };
+    bool m_enabled{ false };
+};
+
+// Entry index of object's vtable. The vtable belongs to object's class, so every
+// object of the class is affected, but calls the compiler made directly aren't.
+class VtableHook : public SlotHook {
+public:
+    VtableHook(Address object, size_t index, Address destination);
+};
+
+#ifdef _WIN32
+// The import address table entry module calls function from dll through.
+// Only calls made by module itself are caught.
+class IatHook : public SlotHook {
+public:
+    IatHook(HMODULE module, std::string_view dll, std::string_view function, Address destination);
+};
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+
+#include "FunctionHook.hpp"
+#include "StaticThunk.hpp"
+
+// A FunctionHook whose detour is a thunk stamped out for Tag, for functions the game calls
+// often enough that the hop through a hook object shows up. See StaticThunk for what Tag provides.
+template <typename Tag, typename Fn>
+class StaticHook;
+
+template <typename Tag, typename Ret, typename... Args>
+class StaticHook<Tag, Ret(Args...)> : public StaticThunk<Tag, Ret(Args...)> {
+public:
+    StaticHook() = delete;
+
+    // The hook still has to be enabled, with create or a FunctionHookTransaction.
+    // There's one thunk per Tag, so only one hook per Tag can exist at a time.
+    static std::unique_ptr<FunctionHook> create(Address target) {
+        // Written before the hook is enabled, and enabling it suspends every thread that could call it.
+        auto hook = std::make_unique<FunctionHook>(target, (uintptr_t)&Thunk::thunk);
+        Thunk::set_original(hook->template get_original<Ret(Args...)>());
+
+        return hook;
+    }
+
+private:
+    using Thunk = StaticThunk<Tag, Ret(Args...)>;
+};
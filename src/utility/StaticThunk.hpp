@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+
+// The detour StaticHook installs, apart from the hook so it can be called without one in place.
+// The original and the dispatching flag are static members with constant initializers, so the
+// thunk reads them straight out of the image, and Tag::dispatch is known at compile time and
+// gets inlined into it.
+//
+// Tag provides
+//     static Ret dispatch(Ret (*original)(Args...), Args... args);
+// which is only called while dispatching is enabled, the original is called directly otherwise.
+template <typename Tag, typename Fn>
+class StaticThunk;
+
+template <typename Tag, typename Ret, typename... Args>
+class StaticThunk<Tag, Ret(Args...)> {
+public:
+    using Fn = Ret(*)(Args...);
+
+    StaticThunk() = delete;
+
+    static Ret thunk(Args... args) {
+        if (!s_dispatching.load(std::memory_order_acquire)) {
+            return s_original(args...);
+        }
+
+        return Tag::dispatch(s_original, args...);
+    }
+
+    // Has to be set before anything can call the thunk, StaticHook::create does it before the hook is enabled.
+    static void set_original(Fn original) {
+        s_original = original;
+    }
+
+    static void set_dispatching(bool dispatching) {
+        s_dispatching.store(dispatching, std::memory_order_release);
+    }
+
+    static Fn get_original() {
+        return s_original;
+    }
+
+private:
+    static inline Fn s_original{ nullptr };
+    static inline std::atomic<bool> s_dispatching{ false };
+};
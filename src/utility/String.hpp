@@ -15,16 +15,25 @@ namespace utility {
     std::string format_string(const char* format, va_list args);
     
     // FNV-1a
-    static constexpr auto hash(std::string_view data) {
+    template <typename Char>
+    static constexpr size_t hash(std::basic_string_view<Char> data) {
         size_t result = 0xcbf29ce484222325;
 
-        for (char c : data) {
+        for (Char c : data) {
             result ^= c;
             result *= (size_t)1099511628211;
         }
 
         return result;
     }
+
+    static constexpr auto hash(std::string_view data) {
+        return hash<char>(data);
+    }
+
+    static constexpr auto hash(std::wstring_view data) {
+        return hash<wchar_t>(data);
+    }
 }
 
 constexpr auto operator "" _fnv(const char* s, size_t) {
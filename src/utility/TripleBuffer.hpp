@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace utility {
+    // Single producer, single consumer channel where neither side ever waits on the other.
+    // The producer fills back() and publishes it, the consumer picks up the newest
+    // published value with front(). Values published in between are skipped.
+    template <typename T>
+    class TripleBuffer {
+    public:
+        // Producer only.
+        T& back() {
+            return m_buffers[m_back];
+        }
+
+        // Producer only. Swaps the back buffer with the shared one and marks it as new.
+        void publish() {
+            auto prev = m_middle.exchange(m_back | DIRTY_BIT, std::memory_order_acq_rel);
+            m_back = prev & INDEX_MASK;
+        }
+
+        // Consumer only. The returned reference stays valid until the next call.
+        const T& front() {
+            if ((m_middle.load(std::memory_order_relaxed) & DIRTY_BIT) != 0) {
+                auto prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+                m_front = prev & INDEX_MASK;
+            }
+
+            return m_buffers[m_front];
+        }
+
+    private:
+        static constexpr uint8_t INDEX_MASK{ 0x3 };
+        static constexpr uint8_t DIRTY_BIT{ 0x4 };
+
+        std::array<T, 3> m_buffers{};
+
+        // Index of the buffer sitting between the two sides, plus whether it's been published since it was last read.
+        std::atomic<uint8_t> m_middle{ 1 };
+        uint8_t m_back{ 0 };
+        uint8_t m_front{ 2 };
+    };
+}
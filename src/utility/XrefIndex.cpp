@@ -0,0 +1,181 @@
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "Instruction.hpp"
+#include "PeImage.hpp"
+#include "XrefIndex.hpp"
+
+using namespace std;
+
+namespace utility {
+    namespace {
+        XrefIndex::Kind get_kind(const hde64s& hs) {
+            switch (hs.opcode) {
+            case 0x8D:
+                return XrefIndex::Kind::LEA;
+            case 0x88:
+            case 0x89:
+            case 0x8A:
+            case 0x8B:
+            case 0xC6:
+            case 0xC7:
+                return XrefIndex::Kind::MOV;
+            case 0xFF:
+                // call/jmp through a pointer, /2 and /3 are calls, /4 and /5 jumps.
+                if (hs.modrm_reg == 2 || hs.modrm_reg == 3) {
+                    return XrefIndex::Kind::CALL;
+                }
+
+                if (hs.modrm_reg == 4 || hs.modrm_reg == 5) {
+                    return XrefIndex::Kind::JMP;
+                }
+
+                return XrefIndex::Kind::OTHER;
+            default:
+                return XrefIndex::Kind::OTHER;
+            }
+        }
+
+        void sort_xrefs(vector<XrefIndex::Xref>& xrefs) {
+            sort(xrefs.begin(), xrefs.end(), [](const auto& a, const auto& b) {
+                return a.target != b.target ? a.target < b.target : a.site < b.site;
+            });
+        }
+    }
+
+#ifdef _WIN32
+    XrefIndex::Ptr XrefIndex::create(HMODULE module) {
+        auto data = (const uint8_t*)module;
+
+        // Only the headers are read before the size is known, they fit in the first page.
+        auto image = parse_pe_image(data, 0x1000);
+
+        if (!image) {
+            spdlog::error("[XrefIndex] Invalid module headers");
+            return nullptr;
+        }
+
+        auto index = Ptr{ new XrefIndex{} };
+        index->m_base = (uintptr_t)module;
+        index->m_image_size = image->size;
+
+        for (auto& section : image->sections) {
+            if (section.is_executable() && section.rva < image->size) {
+                auto size = min(section.virtual_size, image->size - section.rva);
+                index->add_code(data + section.rva, size, section.rva);
+            }
+        }
+
+        sort_xrefs(index->m_xrefs);
+
+        spdlog::info("[XrefIndex] {} references indexed", index->m_xrefs.size());
+
+        return index;
+    }
+#endif
+
+    XrefIndex::Ptr XrefIndex::create_from_file(const uint8_t* data, size_t size) {
+        auto image = parse_pe_image(data, size);
+
+        if (!image) {
+            spdlog::error("[XrefIndex] Invalid PE headers");
+            return nullptr;
+        }
+
+        auto index = Ptr{ new XrefIndex{} };
+        index->m_base = (uintptr_t)image->base;
+        index->m_image_size = image->size;
+
+        for (auto& section : image->sections) {
+            if (!section.is_executable() || section.file_offset >= size) {
+                continue;
+            }
+
+            // The raw data is padded to the file alignment, don't decode the padding.
+            auto section_size = min<size_t>({ section.file_size, section.virtual_size, size - section.file_offset });
+            index->add_code(data + section.file_offset, section_size, section.rva);
+        }
+
+        sort_xrefs(index->m_xrefs);
+
+        return index;
+    }
+
+    XrefIndex::Range XrefIndex::get_references(uintptr_t target) const {
+        if (target < m_base || target - m_base >= m_image_size) {
+            return {};
+        }
+
+        auto rva = (uint32_t)(target - m_base);
+
+        auto first = lower_bound(m_xrefs.begin(), m_xrefs.end(), rva, [](const Xref& x, uint32_t t) { return x.target < t; });
+        auto last = upper_bound(first, m_xrefs.end(), rva, [](uint32_t t, const Xref& x) { return t < x.target; });
+
+        return { m_xrefs.data() + (first - m_xrefs.begin()), m_xrefs.data() + (last - m_xrefs.begin()) };
+    }
+
+    vector<uintptr_t> XrefIndex::get_callers(uintptr_t function) const {
+        vector<uintptr_t> callers{};
+
+        for (auto& xref : get_references(function)) {
+            if (xref.kind == Kind::CALL) {
+                callers.push_back(to_address(xref.site));
+            }
+        }
+
+        return callers;
+    }
+
+    bool XrefIndex::is_code(uintptr_t address, size_t size) const {
+        if (address < m_base) {
+            return false;
+        }
+
+        const auto rva = address - m_base;
+
+        for (auto& section : m_code_sections) {
+            if (rva >= section.rva && rva - section.rva <= section.size && size <= section.size - (rva - section.rva)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // A linear sweep, so anything that isn't code in the middle of a section (jump tables and the like)
+    // can produce a few bogus references, or hide a real one, before the decoder lines back up with the instructions.
+    void XrefIndex::add_code(const uint8_t* code, size_t size, uint32_t rva) {
+        m_code_sections.push_back({ rva, (uint32_t)size });
+
+        for (size_t offset = 0; offset < size; ) {
+            hde64s hs{};
+            auto length = decode_instruction(code + offset, size - offset, hs);
+
+            if (length == 0) {
+                ++offset;
+                continue;
+            }
+
+            const auto next = (int64_t)rva + (int64_t)offset + length;
+
+            int64_t target{ -1 };
+            Kind kind{ Kind::OTHER };
+
+            if ((hs.opcode == 0xE8 || hs.opcode == 0xE9) && (hs.flags & F_IMM32) != 0) {
+                target = next + (int32_t)hs.imm.imm32;
+                kind = hs.opcode == 0xE8 ? Kind::CALL : Kind::JMP;
+            }
+            else if ((hs.flags & F_MODRM) != 0 && hs.modrm_mod == 0 && hs.modrm_rm == 5) {
+                target = next + (int32_t)hs.disp.disp32;
+                kind = hs.opcode == 0x0F ? Kind::OTHER : get_kind(hs);
+            }
+
+            if (target >= 0 && target < m_image_size) {
+                m_xrefs.push_back({ (uint32_t)target, (uint32_t)(rva + offset), kind });
+            }
+
+            offset += length;
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace utility {
+    // Every RIP-relative reference in a module's executable sections, decoded in one pass
+    // and sorted by what they point at. Finding who references a global or calls a function
+    // is then a binary search instead of a pattern scan.
+    class XrefIndex {
+    public:
+        using Ptr = std::unique_ptr<XrefIndex>;
+
+        enum class Kind : uint8_t {
+            LEA,
+            MOV,
+            CALL,
+            JMP,
+            // Any other instruction with a RIP-relative operand (cmp, movss and so on).
+            OTHER,
+        };
+
+        // Both addresses are RVAs, which keeps the table small and independent of where the image is loaded.
+        struct Xref {
+            uint32_t target;
+            // Start of the referencing instruction.
+            uint32_t site;
+            Kind kind;
+        };
+
+        // An executable section that was indexed, relative to the image base.
+        struct Section {
+            uint32_t rva;
+            uint32_t size;
+        };
+
+        struct Range {
+            const Xref* first{ nullptr };
+            const Xref* last{ nullptr };
+
+            auto begin() const {
+                return first;
+            }
+
+            auto end() const {
+                return last;
+            }
+
+            bool empty() const {
+                return first == last;
+            }
+
+            size_t size() const {
+                return last - first;
+            }
+        };
+
+#ifdef _WIN32
+        // Index a module loaded in this process. Returns nullptr if its headers don't look like a PE64 image.
+        static Ptr create(HMODULE module);
+#endif
+        // Index a PE64 file as read from disk, decoding the sections straight out of the file layout.
+        // Addresses are relative to the image base in its headers.
+        static Ptr create_from_file(const uint8_t* data, size_t size);
+
+        XrefIndex(const XrefIndex& other) = delete;
+        XrefIndex& operator=(const XrefIndex& other) = delete;
+        virtual ~XrefIndex() = default;
+
+        auto get_base() const {
+            return m_base;
+        }
+
+        // Sorted by target, then by site.
+        const auto& get_xrefs() const {
+            return m_xrefs;
+        }
+
+        const auto& get_code_sections() const {
+            return m_code_sections;
+        }
+
+        uintptr_t to_address(uint32_t rva) const {
+            return m_base + rva;
+        }
+
+        // Whether all size bytes at address, an absolute address, are inside one indexed section.
+        bool is_code(uintptr_t address, size_t size) const;
+
+        // Every reference to target, an absolute address.
+        Range get_references(uintptr_t target) const;
+        // Addresses of the calls to function, an absolute address. Tail calls through jmp aren't included.
+        std::vector<uintptr_t> get_callers(uintptr_t function) const;
+
+    private:
+        XrefIndex() = default;
+
+        void add_code(const uint8_t* code, size_t size, uint32_t rva);
+
+        uintptr_t m_base{ 0 };
+        uint32_t m_image_size{ 0 };
+        std::vector<Xref> m_xrefs{};
+        std::vector<Section> m_code_sections{};
+    };
+}
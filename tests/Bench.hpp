@@ -0,0 +1,37 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+// Times calls to fn, keeps the best of a few runs to shake off scheduler noise.
+// Reports time per item, for an fn that handles items_per_call items each call.
+namespace bench {
+    // Keeps the compiler from throwing away a result that's never used.
+    template <typename T>
+    inline void keep(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    template <typename Fn>
+    double measure_ns(const char* name, size_t calls, size_t items_per_call, Fn fn) {
+        constexpr int RUNS{ 5 };
+        auto best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < RUNS; ++run) {
+            auto start = std::chrono::steady_clock::now();
+
+            for (size_t i = 0; i < calls; ++i) {
+                fn(i);
+            }
+
+            auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, elapsed / (calls * items_per_call));
+        }
+
+        std::printf("%-40s %8.2f ns\n", name, best);
+
+        return best;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdio>
+
+// Just enough to report failures and set the exit code. Each test is a plain executable run by ctest.
+namespace check {
+    inline int g_checks{ 0 };
+    inline int g_failures{ 0 };
+
+    inline bool report(bool ok, const char* expr, const char* file, int line) {
+        ++g_checks;
+
+        if (!ok) {
+            ++g_failures;
+            std::printf("%s:%d: check failed: %s\n", file, line, expr);
+        }
+
+        return ok;
+    }
+
+    inline int result() {
+        std::printf("%d checks, %d failed\n", g_checks, g_failures);
+        return g_failures == 0 ? 0 : 1;
+    }
+}
+
+#define CHECK(expr) ::check::report((expr), #expr, __FILE__, __LINE__)
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "utility/FileWatcher.hpp"
+
+#include "Check.hpp"
+
+using namespace std::chrono_literals;
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Counts on_change calls, the watcher calls it from its own thread.
+    struct Changes {
+        std::mutex mtx{};
+        std::condition_variable cv{};
+        int count{ 0 };
+
+        void add() {
+            {
+                std::lock_guard _{ mtx };
+                ++count;
+            }
+
+            cv.notify_all();
+        }
+
+        // Whether count reached at least n before the timeout.
+        bool wait_for(int n, std::chrono::milliseconds timeout) {
+            std::unique_lock lock{ mtx };
+            return cv.wait_for(lock, timeout, [&]() { return count >= n; });
+        }
+
+        int get() {
+            std::lock_guard _{ mtx };
+            return count;
+        }
+    };
+
+    void write_file(const fs::path& path, const char* text) {
+        std::ofstream f{ path, std::ios::trunc };
+        f << text;
+    }
+}
+
+int main() {
+    auto dir = fs::temp_directory_path() / ("re2_file_watcher_test_" + std::to_string(getpid()));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    auto path = dir / "config.txt";
+    write_file(path, "a=1\n");
+
+    auto changes = std::make_shared<Changes>();
+    auto watcher = utility::FileWatcher::create(path.string(), [changes]() { changes->add(); });
+
+    CHECK(watcher != nullptr);
+
+    // Written in place.
+    write_file(path, "a=2\n");
+    CHECK(changes->wait_for(1, 2s));
+
+    // Other files in the same directory don't count.
+    auto before = changes->get();
+    write_file(dir / "other.txt", "b=1\n");
+    fs::rename(dir / "other.txt", dir / "other2.txt");
+    std::this_thread::sleep_for(200ms);
+    CHECK(changes->get() == before);
+
+    // Saved by writing a temporary file and renaming it over the watched one.
+    write_file(dir / "config.txt.tmp", "a=3\n");
+    fs::rename(dir / "config.txt.tmp", path);
+    CHECK(changes->wait_for(before + 1, 2s));
+
+    // Nothing is reported once the watcher is gone.
+    watcher.reset();
+    std::this_thread::sleep_for(100ms);
+    before = changes->get();
+    write_file(path, "a=4\n");
+    std::this_thread::sleep_for(200ms);
+    CHECK(changes->get() == before);
+
+    // A directory that doesn't exist can't be watched.
+    CHECK(utility::FileWatcher::create((dir / "missing" / "config.txt").string(), []() {}) == nullptr);
+
+    fs::remove_all(dir);
+
+    return check::result();
+}
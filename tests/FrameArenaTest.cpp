@@ -0,0 +1,136 @@
+#include <cstdlib>
+#include <new>
+
+#include "utility/FrameArena.hpp"
+
+#include "Check.hpp"
+
+using namespace utility;
+
+// Every heap allocation in the process goes through these, so a frame's allocations can be counted.
+namespace {
+    size_t g_allocations{ 0 };
+
+    void* counted_alloc(size_t size, size_t alignment) {
+        ++g_allocations;
+
+        // aligned_alloc wants the size to be a multiple of the alignment.
+        auto p = std::aligned_alloc(alignment, (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment);
+
+        if (p == nullptr) {
+            throw std::bad_alloc{};
+        }
+
+        return p;
+    }
+}
+
+void* operator new(size_t size) {
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return counted_alloc(size, std::max((size_t)alignment, alignof(std::max_align_t)));
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+    // The kind of thing the UI does with the arena: a list of formatted labels and a string built from them.
+    size_t run_frame(FrameArena& arena, int num_labels) {
+        auto labels = arena.make_vector<FrameString>();
+
+        for (int i = 0; i < num_labels; ++i) {
+            labels.push_back(arena.format("enemy {} at slot {}, health {} of {}", "app.ropeway.EnemyController", i, i * 10, 1000));
+        }
+
+        auto text = arena.make_string("In game time: ");
+
+        for (auto& label : labels) {
+            text += label;
+        }
+
+        return text.size();
+    }
+
+    void test_steady_state() {
+        FrameArena arena{ 1024 };
+
+        // Far more than the first block holds, the rest comes from the heap until the reset grows it.
+        run_frame(arena, 200);
+        CHECK(arena.get_used() > arena.get_capacity());
+        arena.reset();
+
+        const auto capacity = arena.get_capacity();
+        CHECK(capacity > 1024);
+        CHECK(arena.get_used() == 0);
+
+        const auto allocations = g_allocations;
+
+        for (int frame = 0; frame < 100; ++frame) {
+            run_frame(arena, 200);
+            arena.reset();
+        }
+
+        CHECK(g_allocations == allocations);
+        CHECK(arena.get_capacity() == capacity);
+
+        // A bigger frame grows it once more, then it settles again.
+        run_frame(arena, 2000);
+        arena.reset();
+        CHECK(arena.get_capacity() > capacity);
+
+        const auto grown_allocations = g_allocations;
+
+        for (int frame = 0; frame < 100; ++frame) {
+            run_frame(arena, 2000);
+            arena.reset();
+        }
+
+        CHECK(g_allocations == grown_allocations);
+    }
+
+    void test_alignment() {
+        FrameArena arena{ 256 };
+        std::pmr::memory_resource& resource = arena;
+
+        auto a = resource.allocate(1, 1);
+        auto b = resource.allocate(8, 64);
+        CHECK(a != b && ((uintptr_t)b & 63) == 0);
+
+        // Doesn't fit, from the heap with the alignment asked for.
+        auto c = resource.allocate(1000, 128);
+        CHECK(((uintptr_t)c & 127) == 0);
+        CHECK(arena.get_used() >= 1000 + 64 + 8);
+
+        arena.reset();
+        CHECK(arena.get_capacity() >= 1000 + 64 + 8 && arena.get_used() == 0);
+
+        // Now it fits in the block.
+        const auto allocations = g_allocations;
+        auto d = resource.allocate(1000, 128);
+        CHECK(((uintptr_t)d & 127) == 0);
+        CHECK(g_allocations == allocations);
+    }
+}
+
+int main() {
+    test_steady_state();
+    test_alignment();
+
+    return check::result();
+}
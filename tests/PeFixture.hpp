@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Builds small PE64 images in memory for the code and import index tests, with only the header
+// fields utility::parse_pe_image reads filled in.
+namespace fixture {
+    constexpr uint64_t BASE{ 0x140000000 };
+    // IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ
+    constexpr uint32_t CODE{ 0x60000020 };
+    // IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ | IMAGE_SCN_MEM_WRITE
+    constexpr uint32_t DATA{ 0xC0000040 };
+
+    constexpr uint32_t NT_OFFSET{ 0x80 };
+    constexpr uint32_t OPTIONAL_HEADER{ NT_OFFSET + 24 };
+    constexpr uint32_t OPTIONAL_HEADER_SIZE{ 0xF0 };
+    constexpr uint32_t HEADERS_SIZE{ 0x400 };
+    constexpr uint32_t FILE_ALIGNMENT{ 0x200 };
+    constexpr uint32_t SECTION_ALIGNMENT{ 0x1000 };
+
+    struct Section {
+        uint32_t rva;
+        std::vector<uint8_t> data;
+        uint32_t characteristics;
+    };
+
+    template <typename T>
+    void put(std::vector<uint8_t>& out, size_t offset, T value) {
+        if (out.size() < offset + sizeof(T)) {
+            out.resize(offset + sizeof(T));
+        }
+
+        std::memcpy(&out[offset], &value, sizeof(T));
+    }
+
+    inline uint32_t align(uint32_t value, uint32_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // mapped lays the sections out at their RVAs, the way the loader would, otherwise they're
+    // packed one after another and padded to the file alignment, the way they are on disk.
+    inline std::vector<uint8_t> build_pe(const std::vector<Section>& sections, bool mapped, uint32_t import_rva = 0, uint32_t import_size = 0) {
+        uint32_t image_size = HEADERS_SIZE;
+
+        for (auto& section : sections) {
+            image_size = std::max(image_size, align(section.rva + (uint32_t)section.data.size(), SECTION_ALIGNMENT));
+        }
+
+        std::vector<uint8_t> out(mapped ? image_size : HEADERS_SIZE);
+
+        put<uint16_t>(out, 0, 0x5A4D);
+        put<uint32_t>(out, 0x3C, NT_OFFSET);
+        put<uint32_t>(out, NT_OFFSET, 0x00004550);
+        put<uint16_t>(out, NT_OFFSET + 4 + 2, (uint16_t)sections.size());
+        put<uint16_t>(out, NT_OFFSET + 4 + 16, (uint16_t)OPTIONAL_HEADER_SIZE);
+        put<uint16_t>(out, OPTIONAL_HEADER, 0x20B);
+        put<uint64_t>(out, OPTIONAL_HEADER + 24, BASE);
+        put<uint32_t>(out, OPTIONAL_HEADER + 56, image_size);
+        put<uint32_t>(out, OPTIONAL_HEADER + 108, 16);
+        put<uint32_t>(out, OPTIONAL_HEADER + 112 + 8, import_rva);
+        put<uint32_t>(out, OPTIONAL_HEADER + 112 + 12, import_size);
+
+        auto header = OPTIONAL_HEADER + OPTIONAL_HEADER_SIZE;
+        uint32_t file_offset = HEADERS_SIZE;
+
+        for (auto& section : sections) {
+            const auto size = (uint32_t)section.data.size();
+            const auto file_size = align(size, FILE_ALIGNMENT);
+            const auto offset = mapped ? section.rva : file_offset;
+
+            put<uint32_t>(out, header + 8, size);
+            put<uint32_t>(out, header + 12, section.rva);
+            put<uint32_t>(out, header + 16, file_size);
+            put<uint32_t>(out, header + 20, offset);
+            put<uint32_t>(out, header + 36, section.characteristics);
+
+            if (out.size() < offset + file_size) {
+                out.resize(offset + file_size);
+            }
+
+            std::copy(section.data.begin(), section.data.end(), out.begin() + offset);
+
+            header += 40;
+            file_offset += file_size;
+        }
+
+        return out;
+    }
+}
@@ -0,0 +1,121 @@
+#include <string>
+#include <vector>
+
+#include "utility/PeImage.hpp"
+
+#include "Check.hpp"
+#include "PeFixture.hpp"
+
+using namespace utility;
+
+namespace {
+    constexpr uint32_t IMPORT_RVA{ 0x2000 };
+    constexpr uint64_t IMPORT_BY_ORDINAL{ 1ull << 63 };
+
+    // Two modules, one with a lookup table and one with only its IAT, with an import by name and one by ordinal.
+    std::vector<uint8_t> build_import_section() {
+        std::vector<uint8_t> data(0x440);
+
+        auto put_descriptor = [&](size_t offset, uint32_t lookup, uint32_t name, uint32_t slots) {
+            fixture::put<uint32_t>(data, offset, lookup);
+            fixture::put<uint32_t>(data, offset + 12, name);
+            fixture::put<uint32_t>(data, offset + 16, slots);
+        };
+
+        auto put_string = [&](size_t offset, const std::string& s) {
+            std::copy(s.begin(), s.end(), data.begin() + offset);
+        };
+
+        put_descriptor(0x00, IMPORT_RVA + 0x100, IMPORT_RVA + 0x300, IMPORT_RVA + 0x200);
+        put_descriptor(0x14, 0, IMPORT_RVA + 0x310, IMPORT_RVA + 0x240);
+
+        // The lookup table and the IAT hold the same thing until the loader binds it.
+        for (auto table : { 0x100, 0x200 }) {
+            fixture::put<uint64_t>(data, table, IMPORT_RVA + 0x400);
+            fixture::put<uint64_t>(data, table + 8, IMPORT_BY_ORDINAL | 42);
+        }
+
+        fixture::put<uint64_t>(data, 0x240, IMPORT_RVA + 0x420);
+
+        put_string(0x300, "KERNEL32.dll");
+        put_string(0x310, "user32.dll");
+        put_string(0x402, "CreateFileW");
+        put_string(0x422, "Sleep");
+
+        return data;
+    }
+
+    void check_imports(const std::vector<PeImport>& imports) {
+        if (!CHECK(imports.size() == 3)) {
+            return;
+        }
+
+        CHECK(imports[0].module == "KERNEL32.dll" && imports[0].name == "CreateFileW" && imports[0].slot == IMPORT_RVA + 0x200);
+        CHECK(imports[1].module == "KERNEL32.dll" && imports[1].name.empty() && imports[1].ordinal == 42 && imports[1].slot == IMPORT_RVA + 0x208);
+        CHECK(imports[2].module == "user32.dll" && imports[2].name == "Sleep" && imports[2].slot == IMPORT_RVA + 0x240);
+    }
+
+    void test_parse_pe_image() {
+        std::vector<fixture::Section> sections{
+            { 0x1000, std::vector<uint8_t>(0x300, 0xCC), fixture::CODE },
+            { IMPORT_RVA, build_import_section(), fixture::DATA },
+        };
+
+        auto file = fixture::build_pe(sections, false, IMPORT_RVA, 0x3C);
+        auto image = parse_pe_image(file.data(), file.size());
+
+        if (!CHECK(image.has_value())) {
+            return;
+        }
+
+        CHECK(image->base == fixture::BASE && image->size == 0x3000);
+        CHECK(image->import_rva == IMPORT_RVA && image->import_size == 0x3C);
+        CHECK(image->sections.size() == 2);
+        CHECK(image->sections[0].is_executable() && !image->sections[1].is_executable());
+        CHECK(image->sections[1].rva == IMPORT_RVA && image->sections[1].virtual_size == 0x440);
+
+        CHECK(image->rva_to_file_offset(IMPORT_RVA + 0x10) == (size_t)image->sections[1].file_offset + 0x10);
+        CHECK(!image->rva_to_file_offset(0x500).has_value());
+
+        // Truncated headers and anything that isn't PE64.
+        CHECK(!parse_pe_image(file.data(), 0x100).has_value());
+        CHECK(!parse_pe_image(nullptr, 0).has_value());
+
+        auto pe32 = file;
+        fixture::put<uint16_t>(pe32, fixture::OPTIONAL_HEADER, 0x10B);
+        CHECK(!parse_pe_image(pe32.data(), pe32.size()).has_value());
+    }
+
+    void test_parse_pe_imports() {
+        std::vector<fixture::Section> sections{
+            { 0x1000, std::vector<uint8_t>(0x300, 0xCC), fixture::CODE },
+            { IMPORT_RVA, build_import_section(), fixture::DATA },
+        };
+
+        auto image = fixture::build_pe(sections, true, IMPORT_RVA, 0x3C);
+        auto file = fixture::build_pe(sections, false, IMPORT_RVA, 0x3C);
+
+        check_imports(parse_pe_imports(image.data(), image.size(), true));
+        check_imports(parse_pe_imports(file.data(), file.size(), false));
+
+        // Read with the wrong layout, the RVAs land outside the data or on the wrong bytes.
+        CHECK(parse_pe_imports(file.data(), file.size(), true).empty());
+
+        // Cut off before the names, the walk ends instead of reading past the data.
+        CHECK(parse_pe_imports(image.data(), IMPORT_RVA + 0x300, true).empty());
+
+        // Cut off before the last name, the imports ahead of it are still all there.
+        auto partial = parse_pe_imports(image.data(), IMPORT_RVA + 0x410, true);
+        CHECK(partial.size() == 2 && partial[0].name == "CreateFileW" && partial[1].ordinal == 42);
+
+        auto no_imports = fixture::build_pe({ sections[0] }, true);
+        CHECK(parse_pe_imports(no_imports.data(), no_imports.size(), true).empty());
+    }
+}
+
+int main() {
+    test_parse_pe_image();
+    test_parse_pe_imports();
+
+    return check::result();
+}
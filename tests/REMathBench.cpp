@@ -0,0 +1,99 @@
+#include <random>
+#include <vector>
+
+#include "REMath.hpp"
+
+#include "Bench.hpp"
+
+using namespace utility::math;
+
+namespace {
+    // What fix_angle did before it was vectorized.
+    float loop_fix_angle(float ang) {
+        auto deg = glm::degrees(ang);
+
+        while (deg > 180.0f) {
+            deg -= 360.0f;
+        }
+
+        while (deg < -180.0f) {
+            deg += 360.0f;
+        }
+
+        return glm::radians(deg);
+    }
+}
+
+int main() {
+    constexpr size_t COUNT{ 1024 };
+
+    std::mt19937 rng{ 1234 };
+    std::uniform_real_distribution<float> dist{ -1.0f, 1.0f };
+
+    std::vector<glm::quat> rotations{};
+    std::vector<glm::mat4> matrices{};
+    std::vector<float> angles{};
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        rotations.push_back(glm::normalize(glm::quat{ dist(rng), dist(rng), dist(rng), dist(rng) }));
+        matrices.push_back(glm::mat4_cast(rotations.back()));
+        angles.push_back(dist(rng) * 20.0f);
+    }
+
+    std::vector<Vector3f> out(COUNT);
+    std::vector<float> wrapped(COUNT);
+
+    std::printf("Per rotation or angle, %zu per pass\n", COUNT);
+
+    bench::measure_ns("glm::extractEulerAngleYZX", 1000, COUNT, [&](size_t) {
+        for (size_t i = 0; i < COUNT; ++i) {
+            float pitch{}, yaw{}, roll{};
+            glm::extractEulerAngleYZX(matrices[i], yaw, roll, pitch);
+            out[i] = { pitch, yaw, roll };
+        }
+
+        bench::keep(out);
+    });
+
+    bench::measure_ns("euler_angles(mat4)", 1000, COUNT, [&](size_t) {
+        for (size_t i = 0; i < COUNT; ++i) {
+            out[i] = euler_angles(matrices[i]);
+        }
+
+        bench::keep(out);
+    });
+
+    bench::measure_ns("euler_angles(matrices, count)", 1000, COUNT, [&](size_t) {
+        euler_angles(matrices.data(), out.data(), COUNT);
+        bench::keep(out);
+    });
+
+    bench::measure_ns("euler_angles(quats, count)", 1000, COUNT, [&](size_t) {
+        euler_angles(rotations.data(), out.data(), COUNT);
+        bench::keep(out);
+    });
+
+    bench::measure_ns("fix_angle loop over degrees", 1000, COUNT, [&](size_t) {
+        for (size_t i = 0; i < COUNT; ++i) {
+            wrapped[i] = loop_fix_angle(angles[i]);
+        }
+
+        bench::keep(wrapped);
+    });
+
+    bench::measure_ns("fix_angle", 1000, COUNT, [&](size_t) {
+        for (size_t i = 0; i < COUNT; ++i) {
+            wrapped[i] = fix_angle(angles[i]);
+        }
+
+        bench::keep(wrapped);
+    });
+
+    bench::measure_ns("fix_angles(angles, count)", 1000, COUNT, [&](size_t) {
+        std::copy(angles.begin(), angles.end(), wrapped.begin());
+        fix_angles(wrapped.data(), COUNT);
+        bench::keep(wrapped);
+    });
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "REMath.hpp"
+
+#include "Check.hpp"
+
+using namespace utility::math;
+
+namespace {
+    // Matches the comment on atan2_ps.
+    constexpr float ATAN2_TOLERANCE{ 2.5e-6f };
+    // atan2_ps error plus what float rounding adds on the way through the decomposition.
+    constexpr float EULER_TOLERANCE{ 2e-5f };
+
+    // What fix_angle did before it was vectorized.
+    float reference_fix_angle(float ang) {
+        auto deg = glm::degrees(ang);
+
+        while (deg > 180.0f) {
+            deg -= 360.0f;
+        }
+
+        while (deg < -180.0f) {
+            deg += 360.0f;
+        }
+
+        return glm::radians(deg);
+    }
+
+    glm::vec3 reference_euler_angles(const glm::mat4& m) {
+        float pitch{}, yaw{}, roll{};
+        glm::extractEulerAngleYZX(m, yaw, roll, pitch);
+
+        return { pitch, yaw, roll };
+    }
+
+    // Difference between two angles, ignoring whole turns, so pi and -pi are the same angle.
+    float angle_error(float a, float b) {
+        return std::abs(std::remainder(a - b, glm::two_pi<float>()));
+    }
+
+    bool near_angles(const glm::vec3& a, const glm::vec3& b, float tolerance) {
+        return angle_error(a[0], b[0]) <= tolerance && angle_error(a[1], b[1]) <= tolerance && angle_error(a[2], b[2]) <= tolerance;
+    }
+
+    float atan2_ps(float y, float x) {
+        float out[4];
+        _mm_storeu_ps(out, utility::math::atan2_ps(_mm_set1_ps(y), _mm_set1_ps(x)));
+        return out[0];
+    }
+
+    void test_atan2() {
+        float max_error = 0.0f;
+
+        // Around the whole circle at magnitudes from denormal to huge.
+        for (auto radius : { 1e-40f, 1e-30f, 1e-10f, 1.0f, 1e10f, 1e30f }) {
+            for (int i = 0; i < 4096; ++i) {
+                auto angle = -glm::pi<float>() + glm::two_pi<float>() * (float)i / 4096.0f;
+                auto y = radius * std::sin(angle);
+                auto x = radius * std::cos(angle);
+
+                max_error = std::max(max_error, std::abs(atan2_ps(y, x) - std::atan2(y, x)));
+            }
+        }
+
+        std::printf("atan2_ps max error %g\n", max_error);
+        CHECK(max_error <= ATAN2_TOLERANCE);
+
+        // Tiny but valid inputs used to be divided by a clamped denominator.
+        CHECK(std::abs(atan2_ps(1e-35f, 1e-35f) - glm::pi<float>() / 4.0f) <= ATAN2_TOLERANCE);
+        CHECK(std::abs(atan2_ps(1e-40f, -1e-40f) - 3.0f * glm::pi<float>() / 4.0f) <= ATAN2_TOLERANCE);
+        CHECK(std::abs(atan2_ps(-1e-38f, 1e-39f) - std::atan2(-1e-38f, 1e-39f)) <= ATAN2_TOLERANCE);
+
+        // Signed zeros give what the standard one gives, down to the sign.
+        for (auto y : { 0.0f, -0.0f }) {
+            for (auto x : { 0.0f, -0.0f }) {
+                auto expected = std::atan2(y, x);
+                auto actual = atan2_ps(y, x);
+
+                CHECK(std::abs(actual - expected) <= ATAN2_TOLERANCE);
+                CHECK(std::signbit(actual) == std::signbit(expected));
+            }
+        }
+
+        CHECK(std::abs(atan2_ps(0.0f, -1.0f) - glm::pi<float>()) <= ATAN2_TOLERANCE);
+        CHECK(std::abs(atan2_ps(-0.0f, -1.0f) + glm::pi<float>()) <= ATAN2_TOLERANCE);
+    }
+
+    void test_fix_angle() {
+        // In range angles come back untouched, the ends included.
+        for (auto ang : { glm::pi<float>(), -glm::pi<float>(), 0.0f, -0.0f, 1.0f, -3.0f }) {
+            CHECK(fix_angle(ang) == ang);
+        }
+
+        float max_error = 0.0f;
+
+        for (int i = -20000; i <= 20000; ++i) {
+            auto ang = (float)i * 0.001f;
+            auto expected = reference_fix_angle(ang);
+            auto actual = fix_angle(ang);
+
+            CHECK(actual >= -glm::pi<float>() && actual <= glm::pi<float>());
+            max_error = std::max(max_error, angle_error(actual, expected));
+        }
+
+        std::printf("fix_angle max error %g\n", max_error);
+        CHECK(max_error <= 1e-5f);
+
+        // The batched version agrees with the scalar one exactly, including the tail.
+        std::vector<float> angles{};
+
+        for (int i = 0; i < 103; ++i) {
+            angles.push_back((float)(i - 51) * 0.37f);
+        }
+
+        angles.push_back(glm::pi<float>());
+        angles.push_back(-glm::pi<float>());
+
+        auto wrapped = angles;
+        fix_angles(wrapped.data(), wrapped.size());
+
+        for (size_t i = 0; i < angles.size(); ++i) {
+            CHECK(wrapped[i] == fix_angle(angles[i]));
+        }
+
+        glm::vec3 v{ glm::pi<float>(), 7.0f, -7.0f };
+        fix_angles(v);
+        CHECK(v[0] == glm::pi<float>() && v[1] == fix_angle(7.0f) && v[2] == fix_angle(-7.0f));
+    }
+
+    void test_euler_angles() {
+        std::mt19937 rng{ 1234 };
+        std::uniform_real_distribution<float> dist{ -1.0f, 1.0f };
+
+        std::vector<glm::quat> rotations{};
+
+        for (int i = 0; i < 4099; ++i) {
+            rotations.push_back(glm::normalize(glm::quat{ dist(rng), dist(rng), dist(rng), dist(rng) }));
+        }
+
+        // Identity, half turns and roll at +-90 degrees, where the decomposition degenerates.
+        const auto h = std::sqrt(0.5f);
+        for (auto q : { glm::quat{ 1, 0, 0, 0 }, glm::quat{ 0, 1, 0, 0 }, glm::quat{ 0, 0, 1, 0 }, glm::quat{ 0, 0, 0, 1 },
+                        glm::quat{ h, 0, 0, h }, glm::quat{ h, 0, 0, -h }, glm::quat{ h, h, 0, 0 }, glm::quat{ h, 0, h, 0 } }) {
+            rotations.push_back(q);
+        }
+
+        std::vector<glm::mat4> matrices{};
+
+        for (auto& q : rotations) {
+            matrices.push_back(glm::mat4_cast(q));
+        }
+
+        // Exact zeros of both signs in the first column.
+        glm::mat4 zeros{ 1.0f };
+        zeros[0][0] = -0.0f;
+        zeros[0][1] = 1.0f;
+        zeros[0][2] = 0.0f;
+        zeros[1][0] = -1.0f;
+        zeros[1][1] = 0.0f;
+        matrices.push_back(zeros);
+        zeros[0][0] = 0.0f;
+        zeros[0][2] = -0.0f;
+        matrices.push_back(zeros);
+
+        int scalar_mismatches = 0;
+
+        for (auto& m : matrices) {
+            if (!near_angles(euler_angles(m), reference_euler_angles(m), 1e-5f)) {
+                ++scalar_mismatches;
+            }
+        }
+
+        CHECK(scalar_mismatches == 0);
+
+        std::vector<Vector3f> batched(matrices.size());
+        euler_angles(matrices.data(), batched.data(), matrices.size());
+
+        int batched_mismatches = 0;
+
+        for (size_t i = 0; i < matrices.size(); ++i) {
+            if (!near_angles(batched[i], reference_euler_angles(matrices[i]), EULER_TOLERANCE)) {
+                ++batched_mismatches;
+            }
+        }
+
+        CHECK(batched_mismatches == 0);
+
+        std::vector<Vector3f> from_quats(rotations.size());
+        euler_angles(rotations.data(), from_quats.data(), rotations.size());
+
+        int quat_mismatches = 0;
+
+        for (size_t i = 0; i < rotations.size(); ++i) {
+            if (!near_angles(from_quats[i], reference_euler_angles(glm::mat4_cast(rotations[i])), EULER_TOLERANCE)) {
+                ++quat_mismatches;
+            }
+        }
+
+        CHECK(quat_mismatches == 0);
+    }
+}
+
+int main() {
+    test_atan2();
+    test_fix_angle();
+    test_euler_angles();
+
+    return check::result();
+}
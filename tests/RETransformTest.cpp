@@ -0,0 +1,128 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utility/String.hpp"
+
+#include "ReClass_Layout.hpp"
+#include "RETransform.hpp"
+
+#include "Check.hpp"
+
+using namespace utility::re_transform;
+
+namespace {
+    // Just the parts of a skeleton the joint lookups read, laid out the way the game does.
+    struct Skeleton {
+        std::vector<std::wstring> names{};
+        std::vector<REJointDesc> descs{};
+        std::vector<REJoint> joints{};
+        std::unique_ptr<N00003745> data{ std::make_unique<N00003745>() };
+        std::unique_ptr<JointMatrices> matrices{ std::make_unique<JointMatrices>() };
+        std::unique_ptr<RETransform> transform{ std::make_unique<RETransform>() };
+
+        explicit Skeleton(const std::vector<std::wstring>& joint_names)
+            : names{ joint_names },
+            descs(joint_names.size()),
+            joints(joint_names.size())
+        {
+            for (size_t i = 0; i < names.size(); ++i) {
+                rename(i, names[i]);
+                descs[i].jointNumber = (int16_t)i;
+                joints[i].info = &descs[i];
+                data->joints[i] = &joints[i];
+            }
+
+            transform->joints.data = data.get();
+            transform->joints.size = (int32_t)names.size();
+            transform->joints.numAllocated = (int32_t)names.size();
+            transform->joints.matrices = matrices.get();
+        }
+
+        // In place, the skeleton's size and first joint stay the same.
+        void rename(size_t i, const std::wstring& name) {
+            names[i] = name;
+            descs[i].name = names[i].data();
+            descs[i].nameHash = hash(name);
+        }
+
+        static uint32_t hash(const std::wstring& name) {
+            return (uint32_t)utility::hash(std::wstring_view{ name });
+        }
+    };
+
+    void test_resolve() {
+        Skeleton skeleton{ { L"root", L"spine", L"head" } };
+        auto& transform = *skeleton.transform;
+
+        auto head = resolve_joint(transform, L"head");
+        CHECK(head.is_valid() && head.index == 2 && head.desc == &skeleton.descs[2]);
+        CHECK(is_joint_valid(transform, head));
+
+        auto spine = resolve_joint(transform, Skeleton::hash(L"spine"));
+        CHECK(spine.is_valid() && spine.index == 1);
+
+        CHECK(!resolve_joint(transform, L"tail").is_valid());
+        CHECK(!resolve_joint(transform, Skeleton::hash(L"tail")).is_valid());
+
+        // A renamed joint is a stale entry, caught by the name check and looked up again.
+        skeleton.rename(2, L"neck");
+        CHECK(!is_joint_valid(transform, resolve_joint(transform, L"head")));
+        CHECK(resolve_joint(transform, L"neck").index == 2);
+        CHECK(resolve_joint(transform, Skeleton::hash(L"neck")).index == 2);
+    }
+
+    // Two joints the skeleton doesn't have, asked for one after the other the way a mod would from
+    // on_update_transform. Each miss used to throw away the other's, so every lookup rebuilt the index.
+    // A rebuild would find a joint renamed in place, so the remembered misses show none happened.
+    void test_alternating_misses() {
+        Skeleton skeleton{ { L"root", L"hips", L"chest", L"neck" } };
+        auto& transform = *skeleton.transform;
+
+        for (int i = 0; i < 4; ++i) {
+            CHECK(!resolve_joint(transform, L"hand_l").is_valid());
+            CHECK(!resolve_joint(transform, L"hand_r").is_valid());
+            CHECK(!resolve_joint(transform, Skeleton::hash(L"hand_l")).is_valid());
+            CHECK(!resolve_joint(transform, Skeleton::hash(L"hand_r")).is_valid());
+        }
+
+        skeleton.rename(3, L"hand_l");
+
+        CHECK(!resolve_joint(transform, L"hand_l").is_valid());
+        CHECK(!resolve_joint(transform, Skeleton::hash(L"hand_l")).is_valid());
+
+        // The stale entry for the old name gives the change away and the misses are forgotten.
+        CHECK(!resolve_joint(transform, L"neck").is_valid());
+        CHECK(resolve_joint(transform, L"hand_l").index == 3);
+        CHECK(resolve_joint(transform, Skeleton::hash(L"hand_l")).index == 3);
+        CHECK(!resolve_joint(transform, L"hand_r").is_valid());
+    }
+
+    // A different size is a different skeleton, nothing remembered about the old one applies.
+    void test_skeleton_change() {
+        Skeleton skeleton{ { L"root", L"hips", L"chest", L"neck", L"head" } };
+        auto& transform = *skeleton.transform;
+
+        CHECK(resolve_joint(transform, L"head").index == 4);
+        CHECK(!resolve_joint(transform, L"tail").is_valid());
+
+        skeleton.rename(4, L"tail");
+        transform.joints.size = 4;
+
+        CHECK(!resolve_joint(transform, L"tail").is_valid());
+        CHECK(!resolve_joint(transform, L"head").is_valid());
+
+        transform.joints.size = 5;
+
+        CHECK(resolve_joint(transform, L"tail").index == 4);
+        CHECK(get_joint(transform, L"tail") == &skeleton.joints[4]);
+    }
+}
+
+int main() {
+    test_resolve();
+    test_alternating_misses();
+    test_skeleton_change();
+
+    return check::result();
+}
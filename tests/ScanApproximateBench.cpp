@@ -0,0 +1,46 @@
+#include <random>
+#include <vector>
+
+#include "utility/ScanApproximate.hpp"
+
+#include "Bench.hpp"
+
+using namespace utility;
+
+// What scan_or_approximate goes through when a pattern stopped matching: a whole code section,
+// a typical 16 byte pattern with a couple of wildcards, 2 mismatches allowed.
+int main() {
+    constexpr size_t SIZE{ 80 * 1024 * 1024 };
+
+    std::mt19937 rng{ 1 };
+    std::vector<uint8_t> code(SIZE);
+
+    // Mostly the common opcodes and small immediates, like real code, so prefixes of the pattern match often.
+    const uint8_t common[]{ 0x48, 0x89, 0x8B, 0x00, 0xFF, 0xE8, 0x0F, 0x85, 0x84, 0xC3, 0xCC, 0x24, 0x5C, 0x83, 0xC0, 0x01 };
+
+    for (auto& b : code) {
+        b = rng() % 4 == 0 ? (uint8_t)rng() : common[rng() % sizeof(common)];
+    }
+
+    const std::vector<int16_t> pattern{ 0x48, 0x89, 0x5C, 0x24, -1, 0x57, 0x48, 0x83, 0xEC, 0x20, 0x48, 0x8B, -1, 0xE8, 0x00, 0xFF };
+
+    std::printf("Per byte scanned, %zu MB\n", SIZE / (1024 * 1024));
+
+    for (uint32_t limit : { 0u, 2u, 4u }) {
+        char name[64]{};
+        std::snprintf(name, sizeof(name), "find_approximate, %u mismatches", limit);
+
+        auto ns = bench::measure_ns(name, 1, SIZE, [&](size_t) {
+            std::vector<ScanMatch> matches{};
+            auto max_mismatches = limit;
+
+            find_approximate(code.data(), code.size(), pattern, max_mismatches, 2, matches);
+            trim_approximate_matches(matches, 2);
+            bench::keep(matches);
+        });
+
+        std::printf("%-40s %8.2f ms\n", "  whole buffer", ns * SIZE / 1e6);
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "utility/ScanApproximate.hpp"
+
+#include "Check.hpp"
+
+using namespace utility;
+
+namespace {
+    // Every position, every byte, no early outs or limit tightening.
+    std::vector<ScanMatch> naive_find_approximate(const std::vector<std::pair<const uint8_t*, size_t>>& ranges,
+        const std::vector<int16_t>& pattern, uint32_t max_mismatches, size_t max_results)
+    {
+        std::vector<ScanMatch> matches{};
+
+        for (auto [data, size] : ranges) {
+            for (size_t offset = 0; offset + pattern.size() <= size; ++offset) {
+                uint32_t mismatches = 0;
+
+                for (size_t i = 0; i < pattern.size(); ++i) {
+                    if (pattern[i] != -1 && pattern[i] != data[offset + i]) {
+                        ++mismatches;
+                    }
+                }
+
+                if (mismatches <= max_mismatches) {
+                    matches.push_back({ (uintptr_t)(data + offset), mismatches });
+                }
+            }
+        }
+
+        std::sort(matches.begin(), matches.end(), [](const ScanMatch& a, const ScanMatch& b) {
+            return a.mismatches != b.mismatches ? a.mismatches < b.mismatches : a.address < b.address;
+        });
+
+        if (matches.size() > max_results) {
+            matches.resize(max_results);
+        }
+
+        return matches;
+    }
+
+    std::vector<ScanMatch> find(const std::vector<std::pair<const uint8_t*, size_t>>& ranges,
+        const std::vector<int16_t>& pattern, uint32_t max_mismatches, size_t max_results)
+    {
+        std::vector<ScanMatch> matches{};
+
+        for (auto [data, size] : ranges) {
+            find_approximate(data, size, pattern, max_mismatches, max_results, matches);
+        }
+
+        trim_approximate_matches(matches, max_results);
+
+        return matches;
+    }
+
+    bool same(const std::vector<ScanMatch>& a, const std::vector<ScanMatch>& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const ScanMatch& x, const ScanMatch& y) {
+            return x.address == y.address && x.mismatches == y.mismatches;
+        });
+    }
+
+    // Small alphabets so there are lots of near matches, at every alignment and with sizes that
+    // leave anywhere from 0 to 15 positions for the scalar tail.
+    void test_matches_naive() {
+        std::mt19937 rng{ 4321 };
+        std::vector<uint8_t> buffer(0x3000);
+        int mismatched = 0;
+
+        for (int round = 0; round < 2000; ++round) {
+            auto alphabet = 2 + rng() % 4;
+
+            for (auto& b : buffer) {
+                b = (uint8_t)(rng() % alphabet);
+            }
+
+            auto offset = rng() % 16;
+            auto size = rng() % (round < 1000 ? 64 : buffer.size() - 16);
+
+            std::vector<int16_t> pattern(1 + rng() % 24);
+
+            for (auto& b : pattern) {
+                b = rng() % 4 == 0 ? -1 : (int16_t)(rng() % alphabet);
+            }
+
+            auto max_mismatches = (uint32_t)(rng() % 8);
+            auto max_results = 1 + rng() % 20;
+
+            std::vector<std::pair<const uint8_t*, size_t>> ranges{ { buffer.data() + offset, size } };
+
+            // Sometimes two ranges sharing the limit, like the sections of a module.
+            if (rng() % 4 == 0) {
+                ranges[0].second /= 2;
+                ranges.push_back({ buffer.data() + offset + ranges[0].second + rng() % 32, ranges[0].second / 2 });
+            }
+
+            if (!same(find(ranges, pattern, max_mismatches, max_results), naive_find_approximate(ranges, pattern, max_mismatches, max_results))) {
+                ++mismatched;
+            }
+        }
+
+        CHECK(mismatched == 0);
+    }
+
+    // Well past MAX_APPROXIMATE_CANDIDATES, so the worst get trimmed and the limit tightened several times over.
+    void test_many_candidates() {
+        std::mt19937 rng{ 99 };
+        std::vector<uint8_t> buffer(0x10000);
+
+        for (auto& b : buffer) {
+            b = (uint8_t)(rng() % 2);
+        }
+
+        const std::vector<int16_t> pattern{ 0, 1, 1, -1, 0, 0, 1, 0, 1, 1, -1, 1 };
+        std::vector<std::pair<const uint8_t*, size_t>> ranges{ { buffer.data() + 3, buffer.size() - 3 } };
+
+        for (uint32_t max_mismatches : { 2u, 5u, 10u }) {
+            CHECK(naive_find_approximate(ranges, pattern, max_mismatches, SIZE_MAX).size() > MAX_APPROXIMATE_CANDIDATES * 3);
+
+            for (size_t max_results : { 1, 16, 1500 }) {
+                CHECK(same(find(ranges, pattern, max_mismatches, max_results), naive_find_approximate(ranges, pattern, max_mismatches, max_results)));
+            }
+        }
+
+        // Every position an exact match, only the lowest addresses are kept.
+        std::vector<uint8_t> zeros(5000);
+        auto matches = find({ { zeros.data(), zeros.size() } }, { 0, 0, 0, 0 }, 3, 4);
+
+        CHECK(matches.size() == 4 && matches[0].address == (uintptr_t)zeros.data() && matches[3].address == (uintptr_t)zeros.data() + 3);
+        CHECK(matches[0].mismatches == 0 && matches[3].mismatches == 0);
+    }
+
+    void test_edges() {
+        std::vector<uint8_t> zeros(400);
+        const std::vector<std::pair<const uint8_t*, size_t>> ranges{ { zeros.data(), zeros.size() } };
+
+        // More mismatches than a byte counter holds.
+        std::vector<int16_t> long_pattern(300, 1);
+        auto matches = find(ranges, long_pattern, 300, 1000);
+
+        CHECK(matches.size() == 101);
+        CHECK(std::all_of(matches.begin(), matches.end(), [](const ScanMatch& m) { return m.mismatches == 300; }));
+        CHECK(find(ranges, long_pattern, 299, 1000).empty());
+
+        // Longer than the data.
+        CHECK(find({ { zeros.data(), 3 } }, { 0, 0, 0, 0 }, 4, 16).empty());
+
+        // All wildcards matches everywhere.
+        CHECK(find({ { zeros.data(), 20 } }, { -1, -1 }, 0, 100).size() == 19);
+    }
+}
+
+int main() {
+    test_matches_naive();
+    test_many_candidates();
+    test_edges();
+
+    return check::result();
+}
@@ -0,0 +1,192 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "utility/SignatureIndex.hpp"
+
+#include "Check.hpp"
+#include "PeFixture.hpp"
+
+using namespace utility;
+
+namespace {
+    constexpr uint32_t CODE_RVA{ 0x1000 };
+
+    std::string to_pattern(const std::vector<int>& bytes) {
+        std::string pattern{};
+
+        for (auto b : bytes) {
+            char text[4]{};
+            std::snprintf(text, sizeof(text), "%02X ", b);
+            pattern += b < 0 ? "? " : text;
+        }
+
+        return pattern;
+    }
+
+    // What utility::scan would find.
+    std::vector<uintptr_t> naive_find_all(const std::vector<uint8_t>& code, uintptr_t base, const std::vector<int>& pattern) {
+        std::vector<uintptr_t> matches{};
+
+        for (size_t offset = 0; offset + pattern.size() <= code.size(); ++offset) {
+            bool match = true;
+
+            for (size_t i = 0; i < pattern.size() && match; ++i) {
+                match = pattern[i] < 0 || pattern[i] == code[offset + i];
+            }
+
+            if (match) {
+                matches.push_back(base + offset);
+            }
+        }
+
+        return matches;
+    }
+
+    // Small alphabets so patterns match in many places, against a plain scan.
+    void test_matches_scan() {
+        std::mt19937 rng{ 1234 };
+        int mismatches = 0;
+        int bad_signatures = 0;
+
+        for (int round = 0; round < 100; ++round) {
+            std::vector<uint8_t> code(64 + rng() % 4000);
+            auto alphabet = 2 + rng() % 6;
+
+            for (auto& b : code) {
+                b = (uint8_t)(rng() % alphabet);
+            }
+
+            auto image = fixture::build_pe({ { CODE_RVA, code, fixture::CODE } }, true);
+            auto index = SignatureIndex::create_from_image(image.data(), image.size());
+
+            if (!CHECK(index != nullptr)) {
+                return;
+            }
+
+            const auto base = fixture::BASE + CODE_RVA;
+
+            for (int query = 0; query < 50; ++query) {
+                std::vector<int> pattern(1 + rng() % 8);
+                auto at = rng() % code.size();
+
+                for (size_t i = 0; i < pattern.size(); ++i) {
+                    if (rng() % 4 == 0) {
+                        pattern[i] = -1;
+                    }
+                    else {
+                        pattern[i] = rng() % 3 == 0 || at + i >= code.size() ? (int)(rng() % alphabet) : code[at + i];
+                    }
+                }
+
+                auto expected = naive_find_all(code, base, pattern);
+
+                if (index->find_all(to_pattern(pattern)) != expected || index->count(to_pattern(pattern)) != expected.size()) {
+                    ++mismatches;
+                }
+            }
+
+            for (int query = 0; query < 20; ++query) {
+                auto address = base + rng() % code.size();
+                auto signature = index->make_signature(address);
+
+                if (signature && index->find_all(*signature) != std::vector<uintptr_t>{ address }) {
+                    ++bad_signatures;
+                }
+            }
+        }
+
+        CHECK(mismatches == 0);
+        CHECK(bad_signatures == 0);
+    }
+
+    void test_make_signature() {
+        std::vector<uint8_t> code(0x80, 0xCC);
+
+        // Two copies of call rel32, mov rax, imm64 that only differ in the operands and the push after them.
+        const uint8_t first[]{ 0xE8, 0x11, 0x11, 0x11, 0x11, 0x48, 0xB8, 1, 2, 3, 4, 5, 6, 7, 8, 0x50 };
+        const uint8_t second[]{ 0xE8, 0x22, 0x22, 0x22, 0x22, 0x48, 0xB8, 9, 10, 11, 12, 13, 14, 15, 16, 0x51 };
+
+        std::copy(std::begin(first), std::end(first), code.begin());
+        std::copy(std::begin(second), std::end(second), code.begin() + 0x40);
+
+        auto image = fixture::build_pe({ { CODE_RVA, code, fixture::CODE } }, true);
+        auto index = SignatureIndex::create_from_image(image.data(), image.size());
+
+        if (!CHECK(index != nullptr)) {
+            return;
+        }
+
+        const auto address = fixture::BASE + CODE_RVA;
+
+        CHECK(index->make_signature(address) == std::string{ "E8 ? ? ? ? 48 B8 ? ? ? ? ? ? ? ? 50" });
+        CHECK(index->make_signature(address + 0x40) == std::string{ "E8 ? ? ? ? 48 B8 ? ? ? ? ? ? ? ? 51" });
+        CHECK(!index->make_signature(address + 0x40, 8).has_value());
+        CHECK(!index->make_signature(address + code.size()).has_value());
+    }
+
+    // A prologue that's been hooked in memory but not on disk.
+    void test_from_file() {
+        std::vector<uint8_t> code(0x300, 0xCC);
+        const uint8_t prologue[]{ 0x48, 0x89, 0x5C, 0x24, 0x08, 0x57, 0x48, 0x83, 0xEC, 0x20 };
+        std::copy(std::begin(prologue), std::end(prologue), code.begin() + 0x100);
+
+        std::vector<uint8_t> more_code(0x40, 0x90);
+        more_code[0x10] = 0xC3;
+
+        std::vector<fixture::Section> sections{
+            { CODE_RVA, code, fixture::CODE },
+            { 0x2000, std::vector<uint8_t>(0x80, 0x11), fixture::DATA },
+            { 0x3000, more_code, fixture::CODE },
+        };
+
+        auto file = fixture::build_pe(sections, false);
+        auto image = fixture::build_pe(sections, true);
+
+        // Past the code section's virtual size, in the file's padding.
+        const uint8_t padding[]{ 0xDE, 0xAD, 0xBE, 0xEF };
+        std::copy(std::begin(padding), std::end(padding), file.begin() + fixture::HEADERS_SIZE + code.size());
+
+        auto from_file = SignatureIndex::create_from_file(file.data(), file.size());
+        auto from_image = SignatureIndex::create_from_image(image.data(), image.size());
+
+        if (!CHECK(from_file != nullptr && from_image != nullptr)) {
+            return;
+        }
+
+        const auto address = fixture::BASE + CODE_RVA + 0x100;
+
+        // Laid out the same way, data section in between included.
+        for (auto pattern : { "48 89 5C 24 08 57", "90 90 C3", "11 11 11 11", "CC CC ? ? ? ? 57" }) {
+            CHECK(from_file->find_all(pattern) == from_image->find_all(pattern));
+        }
+
+        CHECK(from_file->make_signature(address) == from_image->make_signature(address));
+        CHECK(from_file->find_all("DE AD BE EF").empty());
+
+        // Hooking the loaded image changes what it finds, not what the file does.
+        image[CODE_RVA + 0x100] = 0xE9;
+        from_image = SignatureIndex::create_from_image(image.data(), image.size());
+
+        CHECK(from_image->find_all("48 89 5C 24 08 57").empty());
+        CHECK(from_file->find_all("48 89 5C 24 08 57") == std::vector<uintptr_t>{ address });
+
+        // Addresses follow where the module was loaded, not its preferred base.
+        constexpr uintptr_t LOADED{ 0x7FF600000000 };
+        auto relocated = SignatureIndex::create_from_file(file.data(), file.size(), LOADED);
+
+        if (CHECK(relocated != nullptr)) {
+            CHECK(relocated->find_all("48 89 5C 24 08 57") == std::vector<uintptr_t>{ LOADED + CODE_RVA + 0x100 });
+        }
+
+        CHECK(SignatureIndex::create_from_file(file.data(), 0x40) == nullptr);
+    }
+}
+
+int main() {
+    test_matches_scan();
+    test_make_signature();
+    test_from_file();
+
+    return check::result();
+}
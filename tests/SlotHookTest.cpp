@@ -0,0 +1,117 @@
+#include <cstdint>
+
+#include "utility/SlotHook.hpp"
+
+#include "Check.hpp"
+
+namespace {
+    int original(int x) {
+        return x + 1;
+    }
+
+    int detour(int x) {
+        return x * 2;
+    }
+
+    int other_detour(int x) {
+        return x - 1;
+    }
+
+    // A slot in the middle of a table, the entries around it mustn't be touched.
+    void test_slot_hook() {
+        uintptr_t table[]{ 0x1111, (uintptr_t)&original, 0x2222 };
+        auto slot = &table[1];
+
+        {
+            SlotHook hook{ slot, (uintptr_t)&detour };
+
+            CHECK(hook.is_valid());
+            CHECK(hook.get_original() == (uintptr_t)&original);
+            CHECK(*slot == (uintptr_t)&original);
+
+            CHECK(hook.create());
+            CHECK(*slot == (uintptr_t)&detour);
+            CHECK(((int (*)(int))*slot)(5) == 10);
+            CHECK(hook.get_original<int(int)>()(5) == 6);
+
+            // Creating it twice is harmless.
+            CHECK(hook.create());
+            CHECK(*slot == (uintptr_t)&detour);
+
+            CHECK(hook.remove());
+            CHECK(*slot == (uintptr_t)&original);
+            CHECK(hook.remove());
+
+            // Removing it doesn't stop it from being created again.
+            CHECK(hook.is_valid());
+            CHECK(hook.create());
+            CHECK(*slot == (uintptr_t)&detour);
+        }
+
+        // The destructor took it out.
+        CHECK(*slot == (uintptr_t)&original);
+        CHECK(table[0] == 0x1111 && table[2] == 0x2222);
+    }
+
+    void test_hooked_over() {
+        uintptr_t slot{ (uintptr_t)&original };
+
+        SlotHook hook{ &slot, (uintptr_t)&detour };
+        CHECK(hook.create());
+
+        // Another hook went in on top, it still calls ours, so ours can't come out.
+        slot = (uintptr_t)&other_detour;
+        CHECK(!hook.remove());
+        CHECK(slot == (uintptr_t)&other_detour);
+
+        // Once that one is gone it can.
+        slot = (uintptr_t)&detour;
+        CHECK(hook.remove());
+        CHECK(slot == (uintptr_t)&original);
+
+        // Replaced between reading the original and creating the hook, chaining on would skip the replacement.
+        SlotHook stale{ &slot, (uintptr_t)&detour };
+        slot = (uintptr_t)&other_detour;
+        CHECK(!stale.create());
+        CHECK(!stale.is_valid());
+        CHECK(slot == (uintptr_t)&other_detour);
+    }
+
+    void test_invalid() {
+        SlotHook no_slot{ nullptr, (uintptr_t)&detour };
+        CHECK(!no_slot.is_valid());
+        CHECK(!no_slot.create());
+
+        uintptr_t slot{ (uintptr_t)&original };
+        SlotHook no_destination{ &slot, nullptr };
+        CHECK(!no_destination.create());
+        CHECK(slot == (uintptr_t)&original);
+    }
+
+    void test_vtable_hook() {
+        uintptr_t vtable[]{ 0x1111, 0x2222, (uintptr_t)&original };
+        struct Object {
+            uintptr_t* vtable;
+        } object{ vtable };
+
+        VtableHook hook{ &object, 2, (uintptr_t)&detour };
+
+        CHECK(hook.get_original() == (uintptr_t)&original);
+        CHECK(hook.create());
+        CHECK(vtable[2] == (uintptr_t)&detour && vtable[0] == 0x1111 && vtable[1] == 0x2222);
+        CHECK(hook.remove());
+        CHECK(vtable[2] == (uintptr_t)&original);
+
+        VtableHook no_object{ nullptr, 2, (uintptr_t)&detour };
+        CHECK(!no_object.is_valid());
+    }
+}
+
+int main() {
+    test_slot_hook();
+    test_hooked_over();
+    test_invalid();
+    test_vtable_hook();
+
+    return check::result();
+}
@@ -0,0 +1,162 @@
+#include <memory>
+#include <vector>
+
+#include "utility/StaticThunk.hpp"
+
+#include "Bench.hpp"
+
+// What a hooked call costs on top of the original, through StaticThunk and through the dispatch
+// PositionHooks used before it, both calling the same mods. The game reaches the detour through
+// a jmp patched into the function, a call through a volatile pointer stands in for that.
+namespace {
+    struct Transform {
+        float position[4];
+    };
+
+    struct Mod {
+        virtual ~Mod() = default;
+        virtual void on_pre_update_transform(Transform*) {}
+        virtual void on_update_transform(Transform*) {}
+    };
+
+    struct PositionMod : Mod {
+        void on_update_transform(Transform* t) override {
+            bench::keep(t->position[0]);
+        }
+    };
+
+    std::vector<std::shared_ptr<Mod>> g_mods{};
+
+    __attribute__((noinline)) void* update_transform(Transform* t, uint8_t a2, uint32_t a3) {
+        t->position[0] += (float)(a2 + a3);
+        return t;
+    }
+
+    // The old way: a static detour forwarding to a member of the hooks object through a global, which
+    // asks the framework whether it's ready and gets the original from the hook object on every call.
+    namespace old {
+        struct FunctionHook {
+            uintptr_t original;
+
+            template <typename T>
+            T* get_original() const {
+                return (T*)original;
+            }
+        };
+
+        struct Framework {
+            bool game_data_initialized{ true };
+            std::vector<std::shared_ptr<Mod>>* mods{ &g_mods };
+
+            bool is_ready() const {
+                return game_data_initialized;
+            }
+
+            const auto& get_mods() const {
+                return *mods;
+            }
+        };
+
+        std::unique_ptr<Framework> g_framework{};
+
+        struct PositionHooks {
+            std::unique_ptr<FunctionHook> m_update_transform_hook{};
+
+            void* update_transform_hook_internal(Transform* t, uint8_t a2, uint32_t a3);
+            static void* update_transform_hook(Transform* t, uint8_t a2, uint32_t a3);
+        };
+
+        PositionHooks* g_hook{ nullptr };
+
+        void* PositionHooks::update_transform_hook_internal(Transform* t, uint8_t a2, uint32_t a3) {
+            if (!g_framework->is_ready()) {
+                return m_update_transform_hook->get_original<decltype(update_transform_hook)>()(t, a2, a3);
+            }
+
+            auto& mods = g_framework->get_mods();
+
+            for (auto& mod : mods) {
+                mod->on_pre_update_transform(t);
+            }
+
+            auto ret = m_update_transform_hook->get_original<decltype(update_transform_hook)>()(t, a2, a3);
+
+            for (auto& mod : mods) {
+                mod->on_update_transform(t);
+            }
+
+            return ret;
+        }
+
+        __attribute__((noinline)) void* PositionHooks::update_transform_hook(Transform* t, uint8_t a2, uint32_t a3) {
+            return g_hook->update_transform_hook_internal(t, a2, a3);
+        }
+    }
+
+    struct UpdateTransform {
+        static void* dispatch(void* (*original)(Transform*, uint8_t, uint32_t), Transform* t, uint8_t a2, uint32_t a3) {
+            for (auto& mod : g_mods) {
+                mod->on_pre_update_transform(t);
+            }
+
+            auto ret = original(t, a2, a3);
+
+            for (auto& mod : g_mods) {
+                mod->on_update_transform(t);
+            }
+
+            return ret;
+        }
+    };
+
+    using UpdateTransformThunk = StaticThunk<UpdateTransform, void*(Transform*, uint8_t, uint32_t)>;
+
+    using UpdateTransformFn = void* (*)(Transform*, uint8_t, uint32_t);
+
+    void measure(const char* name, UpdateTransformFn fn) {
+        constexpr size_t CALLS{ 10'000'000 };
+
+        Transform transform{};
+        volatile UpdateTransformFn target{ fn };
+
+        bench::measure_ns(name, CALLS, 1, [&](size_t i) {
+            bench::keep(target(&transform, (uint8_t)i, 1));
+        });
+    }
+}
+
+int main() {
+    old::g_framework = std::make_unique<old::Framework>();
+
+    old::PositionHooks hooks{};
+    hooks.m_update_transform_hook = std::make_unique<old::FunctionHook>(old::FunctionHook{ (uintptr_t)&update_transform });
+    old::g_hook = &hooks;
+
+    UpdateTransformThunk::set_original(&update_transform);
+
+    std::printf("Per call\n");
+
+    measure("original", &update_transform);
+
+    // Framework not ready yet, straight through to the original.
+    old::g_framework->game_data_initialized = false;
+    measure("old dispatch, not ready", &old::PositionHooks::update_transform_hook);
+    measure("StaticThunk, not dispatching", &UpdateTransformThunk::thunk);
+
+    old::g_framework->game_data_initialized = true;
+    UpdateTransformThunk::set_dispatching(true);
+
+    for (auto num_mods : { 0, 1, 8 }) {
+        g_mods.clear();
+
+        for (int i = 0; i < num_mods; ++i) {
+            g_mods.push_back(std::make_shared<PositionMod>());
+        }
+
+        std::printf("%d mods\n", num_mods);
+        measure("old dispatch", &old::PositionHooks::update_transform_hook);
+        measure("StaticThunk", &UpdateTransformThunk::thunk);
+    }
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <vector>
+
+#include "utility/Instruction.hpp"
+#include "utility/XrefIndex.hpp"
+
+#include "Check.hpp"
+#include "PeFixture.hpp"
+
+using namespace utility;
+
+namespace {
+    constexpr uint32_t CODE_RVA{ 0x1000 };
+    constexpr uint32_t DATA_RVA{ 0x2000 };
+
+    // mov rax, 0x8000000000000000, what REGlobals looks for after the lea.
+    const std::vector<uint8_t> MOV_RAX{ 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80 };
+
+    struct Code {
+        std::vector<uint8_t> bytes{};
+
+        uint32_t rva() const {
+            return CODE_RVA + (uint32_t)bytes.size();
+        }
+
+        void add(const std::vector<uint8_t>& more) {
+            bytes.insert(bytes.end(), more.begin(), more.end());
+        }
+
+        // opcode plus a rel32 or disp32 pointing at target.
+        uint32_t add_relative(const std::vector<uint8_t>& opcode, uint32_t target) {
+            auto site = rva();
+            add(opcode);
+
+            auto disp = (int32_t)(target - (site + opcode.size() + 4));
+            bytes.resize(bytes.size() + 4);
+            std::memcpy(&bytes[bytes.size() - 4], &disp, 4);
+
+            return site;
+        }
+
+        // lea rcx, [target]
+        uint32_t add_lea(uint32_t target) {
+            return add_relative({ 0x48, 0x8D, 0x0D }, target);
+        }
+
+        uint32_t add_registration(uint32_t global) {
+            auto site = add_lea(global);
+            add(MOV_RAX);
+
+            return site;
+        }
+    };
+
+    bool has_reference(const XrefIndex& index, uint32_t target, uint32_t site, XrefIndex::Kind kind) {
+        for (auto& xref : index.get_references(index.to_address(target))) {
+            if (xref.site == site && xref.kind == kind) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void test_decode_instruction() {
+        // lea rcx, [rip+0x10]
+        const uint8_t lea[]{ 0x48, 0x8D, 0x0D, 0x10, 0x00, 0x00, 0x00 };
+
+        hde64s hs{};
+        CHECK(decode_instruction(lea, sizeof(lea), hs) == sizeof(lea));
+        CHECK(hs.opcode == 0x8D && hs.disp.disp32 == 0x10);
+
+        // Cut off by the end of the code, the padding mustn't be taken for the rest of it.
+        CHECK(decode_instruction(lea, sizeof(lea) - 1, hs) == 0);
+        CHECK(decode_instruction(lea, 1, hs) == 0);
+    }
+
+    void test_xref_index() {
+        Code code{};
+
+        auto first = code.add_registration(DATA_RVA);
+        auto call = code.add_relative({ 0xE8 }, CODE_RVA);
+
+        // The start of a mov rax, imm64 with no immediate, like a jump table entry would leave. The decoder
+        // takes the next registration's lea as the immediate and only lines back up in the padding after it.
+        // That registration is lost to the index, which is why REGlobals scans for the sequence as well.
+        code.add({ 0x48, 0xB8 });
+        code.add_registration(DATA_RVA + 0x8);
+        code.add(std::vector<uint8_t>(8, 0xCC));
+
+        auto after_desync = code.add_registration(DATA_RVA + 0x10);
+        code.add({ 0xC3 });
+
+        // Right at the end of the section, decoded from the padded copy.
+        auto last = code.add_lea(DATA_RVA + 0x18);
+        auto code_size = code.bytes.size();
+
+        auto file = fixture::build_pe({ { CODE_RVA, code.bytes, fixture::CODE }, { DATA_RVA, std::vector<uint8_t>(0x40), fixture::DATA } }, false);
+        auto index = XrefIndex::create_from_file(file.data(), file.size());
+
+        if (!CHECK(index != nullptr)) {
+            return;
+        }
+
+        CHECK(index->get_base() == fixture::BASE);
+        CHECK(has_reference(*index, DATA_RVA, first, XrefIndex::Kind::LEA));
+        CHECK(has_reference(*index, DATA_RVA + 0x10, after_desync, XrefIndex::Kind::LEA));
+        CHECK(has_reference(*index, DATA_RVA + 0x18, last, XrefIndex::Kind::LEA));
+
+        auto callers = index->get_callers(index->to_address(CODE_RVA));
+        CHECK(callers.size() == 1 && callers[0] == index->to_address(call));
+
+        // Sorted by target, then site.
+        auto& xrefs = index->get_xrefs();
+
+        for (size_t i = 1; i < xrefs.size(); ++i) {
+            CHECK(xrefs[i - 1].target < xrefs[i].target || (xrefs[i - 1].target == xrefs[i].target && xrefs[i - 1].site <= xrefs[i].site));
+        }
+
+        // Only the code section is indexed, and only as far as its virtual size, not the file padding.
+        CHECK(index->get_code_sections().size() == 1);
+        CHECK(index->get_code_sections()[0].rva == CODE_RVA && index->get_code_sections()[0].size == code_size);
+
+        // What REGlobals checks before reading a registration at a site.
+        const auto registration_size = 7 + MOV_RAX.size();
+
+        CHECK(index->is_code(index->to_address(first), registration_size));
+        CHECK(index->is_code(index->to_address(last), 7));
+        CHECK(!index->is_code(index->to_address(last), registration_size));
+        CHECK(index->is_code(index->to_address(CODE_RVA), code_size));
+        CHECK(!index->is_code(index->to_address(CODE_RVA - 1), 2));
+        CHECK(!index->is_code(index->to_address(DATA_RVA), 1));
+        CHECK(!index->is_code(0, 1));
+    }
+}
+
+int main() {
+    test_decode_instruction();
+    test_xref_index();
+
+    return check::result();
+}